@@ -1,62 +1,299 @@
 #include "benchmark_reader.h"
 #include <stdexcept>
-#include <sstream>
+#include <cstdio>
+#include <climits>
+#include <cstdlib>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
 #include "disjunction_clause.h"
+#include "input_source.h"
+#include "cnf_cache.h"
 
-Benchmark_reader::Benchmark_reader(std::string file_name){
-    std::ifstream ifs(file_name);
-    if(!ifs){
-        throw std::invalid_argument("Cannot open file " + file_name);
+namespace {
+
+class Chunk_reader{
+    /*
+    Sequential character access to an input source that is read in large chunks, so the parser never goes through
+    a per-line or per-token stream.
+    */
+public:
+    explicit Chunk_reader(Input_source &s) : source(s), buffer(CHUNK_SIZE), position(0), end(0) {}
+
+    // Return the current character, or EOF at the end of the file.
+    int peek(){
+        if(position == end && !refill()){
+            return EOF;
+        }
+        return static_cast<unsigned char>(buffer[position]);
+    }
+
+    void advance(){
+        ++position;
+    }
+
+private:
+    static const size_t CHUNK_SIZE = 1 << 20;
+
+    bool refill(){
+        end = source.read(buffer.data(), buffer.size());
+        position = 0;
+        return end != 0;
+    }
+
+    Input_source &source;
+    std::vector<char> buffer;
+    size_t position, end;
+};
+
+bool is_space(int c){
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+void skip_line(Chunk_reader &in){
+    int c;
+    while((c = in.peek()) != EOF && c != '\n'){
+        in.advance();
+    }
+}
+
+void skip_spaces(Chunk_reader &in){
+    while(is_space(in.peek())){
+        in.advance();
+    }
+}
+
+std::string read_word(Chunk_reader &in){
+    std::string word;
+    int c;
+    while((c = in.peek()) != EOF && !is_space(c)){
+        word.push_back(static_cast<char>(c));
+        in.advance();
+    }
+    return word;
+}
+
+long long read_integer(Chunk_reader &in, const std::string &file_name){
+    /*
+    Read a decimal integer with an optional minus sign. Values outside the range of int are rejected.
+    */
+    bool negative = false;
+    if(in.peek() == '-'){
+        negative = true;
+        in.advance();
+    }
+    int c = in.peek();
+    if(c < '0' || c > '9'){
+        throw std::runtime_error("Benchmark " + file_name + " contains a malformed integer.");
+    }
+    long long value = 0;
+    while((c = in.peek()) >= '0' && c <= '9'){
+        value = value * 10 + (c - '0');
+        if(value > INT_MAX){
+            throw std::runtime_error("Benchmark " + file_name + " contains a literal out of range.");
+        }
+        in.advance();
+    }
+    return negative ? -value : value;
+}
+
+class Clause_normalizer{
+    /*
+    Add clauses to a formula with their literals sorted and deduplicated, dropping tautologies and clauses that are
+    already in the formula. Clauses are found through an open-addressing table (linear probing) of their
+    ClauseHash and index in the formula; keeping the hashes in the table means equal clauses are only compared
+    when their full 64-bit hashes match.
+    */
+public:
+    Clause_normalizer(Conjunction_clause &c, Normalization_statistics &s) : cnf(c), stats(s), used(0) {}
+
+    void reserve(size_t num_clauses){
+        size_t size = 1024;
+        while(size < 2 * num_clauses){
+            size *= 2;
+        }
+        if(size > slots.size()){
+            rehash(size);
+        }
+    }
+
+    void add(std::vector<Literal> literals){
+        Disjunction_clause dc(std::move(literals));
+        size_t size = dc.size();
+        bool tautology = !dc.normalize();
+        stats.duplicate_literals += size - dc.size();
+        if(tautology){
+            /*
+            The clause is dropped, but its variables still belong to the formula and must get a value in the model.
+            The literals are sorted, so both literals of a variable are neighbours.
+            */
+            ++stats.tautologies;
+            for(size_t i = 0; i != dc.size(); ++i){
+                if(i == 0 || dc[i].get_variable() != dc[i - 1].get_variable()){
+                    cnf.add_unconstrained_variable(dc[i].get_variable());
+                }
+            }
+            return;
+        }
+
+        if(2 * (used + 1) > slots.size()){
+            rehash(std::max<size_t>(1024, 2 * slots.size()));
+        }
+        uint64_t hash = ClauseHash()(dc);
+        size_t mask = slots.size() - 1;
+        size_t i = hash & mask;
+        for(; slots[i].index != EMPTY; i = (i + 1) & mask){
+            if(slots[i].hash == hash && cnf.get_clauses()[slots[i].index] == dc){
+                ++stats.duplicate_clauses;
+                return;
+            }
+        }
+        slots[i].hash = hash;
+        slots[i].index = cnf.size();
+        ++used;
+        cnf.add_clause(std::move(dc));
+    }
+
+private:
+    struct Slot{
+        uint64_t hash;
+        size_t index;
+    };
+
+    static const size_t EMPTY = SIZE_MAX;
+
+    void rehash(size_t size){
+        std::vector<Slot> old(size, Slot{0, EMPTY});
+        old.swap(slots);
+        for(auto &slot : old){
+            if(slot.index != EMPTY){
+                size_t i = slot.hash & (size - 1);
+                while(slots[i].index != EMPTY){
+                    i = (i + 1) & (size - 1);
+                }
+                slots[i] = slot;
+            }
+        }
     }
 
-    std::string line;
-    size_t num_var, num_clauses;
-    std::vector<int> v;
+    Conjunction_clause &cnf;
+    Normalization_statistics &stats;
+    // Power-of-two table, at most half full.
+    std::vector<Slot> slots;
+    size_t used;
+};
+
+}
+
+std::ostream& operator<<(std::ostream &os, const Normalization_statistics &s){
+    os << "c duplicate literals: " << s.duplicate_literals << "\n";
+    os << "c tautologies: " << s.tautologies << "\n";
+    os << "c duplicate clauses: " << s.duplicate_clauses << "\n";
+    return os;
+}
+
+Benchmark_reader::Benchmark_reader(std::string file_name, bool use_cache){
+    /*
+    A file that is itself a cache is always loaded as such. Otherwise, with use_cache, the cache next to the file is
+    loaded if it was built from the current content of the file, and (re)built from the parsed file if it was not.
+    Failing to write the cache is only reported on stderr.
+    */
+    if(Cnf_cache::is_cache_file(file_name)){
+        Cnf_cache cache(file_name);
+        if(!cache.is_valid()){
+            throw std::runtime_error("Benchmark " + file_name + " is a corrupted cache.");
+        }
+        this->cc = cache.to_formula();
+        return;
+    }
+    if(!use_cache){
+        parse_dimacs(file_name);
+        return;
+    }
+
+    uint64_t source_hash = Cnf_cache::hash_file(file_name);
+    std::string cache_name = file_name + ".cache";
+    if(Cnf_cache::is_cache_file(cache_name)){
+        Cnf_cache cache(cache_name);
+        if(cache.is_valid() && cache.get_source_hash() == source_hash){
+            this->cc = cache.to_formula();
+            return;
+        }
+    }
+    parse_dimacs(file_name);
+    try{
+        Cnf_cache::write(cache_name, this->cc, source_hash);
+    }
+    catch(const std::runtime_error &e){
+        // The formula is parsed; a cache that cannot be written only costs the next run a parse.
+        std::cerr << "c warning: " << e.what() << "\n";
+    }
+}
+
+void Benchmark_reader::parse_dimacs(const std::string &file_name){
+    /*
+    Parse a DIMACS CNF file. Clauses are sequences of non-zero literals terminated by 0 and may span several lines;
+    lines starting with 'c' are comments wherever they appear, and a '%' line (as in the SATLIB benchmarks) ends
+    the formula. The "p cnf" header, when present, is used to preallocate the formula.
+    Clauses are normalized as they are read, see Clause_normalizer.
+    Files compressed with gzip, xz or bzip2 are decompressed while they are parsed.
+    */
+    std::unique_ptr<Input_source> source = Input_source::open(file_name);
+    Chunk_reader in(*source);
     Conjunction_clause cnf;
+    Clause_normalizer normalizer(cnf, this->normalization);
+    std::vector<Literal> literals;
 
-    while(getline(ifs, line)){
-        if(line[0] == 'c'){
+    while(true){
+        skip_spaces(in);
+        int c = in.peek();
+        if(c == EOF){
+            break;
+        }
+        else if(c == 'c'){
             // Comment line
-            continue;
-        }
-        else if(line[0] == 'p'){
-            std::istringstream iss(line);
-            std::string term;
-            
-            // There should be exactly 4 terms in a 'p' line.
-            iss >> term >> term;
-            if(term != "cnf"){
-                std::cerr << term << std::endl;
+            skip_line(in);
+        }
+        else if(c == 'p'){
+            in.advance();
+            skip_spaces(in);
+            if(read_word(in) != "cnf"){
                 throw std::runtime_error("Benchmark " + file_name + " does not contain formula in CNF.");
             }
-            iss >> num_var;
-            iss >> num_clauses;
+            skip_spaces(in);
+            long long num_var = read_integer(in, file_name);
+            skip_spaces(in);
+            long long num_clauses = read_integer(in, file_name);
+            if(num_var < 0 || num_clauses < 0){
+                throw std::runtime_error("Benchmark " + file_name + " has a malformed header.");
+            }
+            cnf.reserve_variables(num_var);
+            cnf.reserve_clauses(num_clauses);
+            normalizer.reserve(num_clauses);
         }
-        else if(line[0] == '%'){
+        else if(c == '%'){
             break;
         }
-        else{
-            // A clause line
-            std::istringstream iss(line);
-            int num;
-            while(iss >> num){
-                if(num == 0){
-                    // Create variables, then create a disjunction_clause.
-                    Disjunction_clause dc;
-                    for(auto e : v){
-                        dc.add_literal(Literal(Variable("x" + std::to_string(abs(e))), abs(e) == e));
-                    }
-                    cnf.add_clause(dc);
-
-                    v.clear();
-                }
-                else{
-                    v.push_back(num);
-                }
-                
+        else if(c == '-' || (c >= '0' && c <= '9')){
+            int num = static_cast<int>(read_integer(in, file_name));
+            if(num == 0){
+                normalizer.add(literals);
+                literals.clear();
+            }
+            else{
+                literals.push_back(Literal(Variable(std::abs(num) - 1), num > 0));
             }
         }
+        else{
+            throw std::runtime_error("Benchmark " + file_name + " contains unexpected character '" + std::string(1, static_cast<char>(c)) + "'.");
+        }
+    }
+
+    // Accept a last clause without its terminating 0.
+    if(!literals.empty()){
+        normalizer.add(literals);
     }
 
-    this->cc = cnf;
-};
\ No newline at end of file
+    this->cc = std::move(cnf);
+}
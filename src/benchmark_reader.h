@@ -2,20 +2,41 @@
 #define BENCHMARK_READER_H
 
 #include "conjunction_clause.h"
-#include <fstream>
+#include <cstdint>
+#include <iostream>
 #include <string>
 
+class Normalization_statistics{
+    // What was removed from the clauses of a benchmark while it was parsed.
+public:
+    Normalization_statistics() : duplicate_literals(0), tautologies(0), duplicate_clauses(0) {}
+
+    uint64_t duplicate_literals;
+    uint64_t tautologies;
+    uint64_t duplicate_clauses;
+};
+
+std::ostream& operator<<(std::ostream &os, const Normalization_statistics &s);
+
 class Benchmark_reader{
 public:
-    // Read a benchmark file, put the read CNF into cc.
-    Benchmark_reader(std::string file_name);
+    // Read a benchmark file, put the read CNF into cc. With use_cache, go through the binary cache file_name.cache.
+    Benchmark_reader(std::string file_name, bool use_cache = false);
 
-    Conjunction_clause get_formula(){
+    const Conjunction_clause& get_formula() const{
         return this->cc;
     }
 
+    // Counters of the clause normalization done while parsing; all zero for a formula loaded from a cache.
+    const Normalization_statistics& get_normalization_statistics() const{
+        return this->normalization;
+    }
+
 private:
+    void parse_dimacs(const std::string &file_name);
+
     Conjunction_clause cc;
+    Normalization_statistics normalization;
 };
 
 
@@ -0,0 +1,120 @@
+#include "benchmark_reader.h"
+#include "preprocessor.h"
+#include "solver.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+static int failures = 0;
+
+static void check(bool condition, const char *message){
+    if(!condition){
+        std::cout << "FAILED: " << message << "\n";
+        ++failures;
+    }
+}
+
+static void write_file(const std::string &file_name, const std::string &content){
+    std::ofstream ofs(file_name, std::ios::binary | std::ios::trunc);
+    ofs << content;
+}
+
+static bool fails_to_decompress(const std::string &file_name){
+    /*
+    Whether reading file_name is stopped by a decompression error, rather than parsing the data before the error.
+    */
+    try{
+        Benchmark_reader br(file_name);
+    }
+    catch(const std::runtime_error &e){
+        return std::string(e.what()).find("Cannot decompress") == 0;
+    }
+    return false;
+}
+
+static bool is_model_of(const std::vector<Literal> &model, const std::vector<std::vector<int>> &clauses, size_t num_variables){
+    /*
+    Whether model gives exactly one value to each of the num_variables variables and satisfies all clauses, given
+    as DIMACS literals.
+    */
+    std::vector<int> value(num_variables, 0);
+    for(auto &l : model){
+        size_t v = l.get_variable().get_index();
+        if(v >= num_variables || value[v] != 0){
+            return false;
+        }
+        value[v] = l.get_value() ? 1 : -1;
+    }
+    for(auto &clause : clauses){
+        bool satisfied = false;
+        for(int lit : clause){
+            if(value[std::abs(lit) - 1] == (lit > 0 ? 1 : -1)){
+                satisfied = true;
+            }
+        }
+        if(!satisfied){
+            return false;
+        }
+    }
+    for(int v : value){
+        if(v == 0){
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::vector<Literal> solve(const Conjunction_clause &cnf, bool preprocess){
+    if(!preprocess){
+        Solver s(cnf);
+        return s.solve() == Solve_result::Satisfiable ? s.get_model() : std::vector<Literal>();
+    }
+    Preprocessor p(cnf);
+    p.run();
+    Solver s(p.get_formula());
+    return s.solve() == Solve_result::Satisfiable ? p.extend_model(s.get_model()) : std::vector<Literal>();
+}
+
+int main(){
+    // x1 and x3 only occur in a tautology, which the reader drops; they must still be part of the model.
+    std::string file_name = "benchmark_reader_test.cnf";
+    std::vector<std::vector<int>> clauses = {{1, -1, 3}, {2}};
+    write_file(file_name, "p cnf 3 2\n1 -1 3 0\n2 0\n");
+
+    Benchmark_reader parsed(file_name);
+    check(parsed.get_normalization_statistics().tautologies == 1, "tautology is dropped");
+    check(parsed.get_formula().get_variables_in_clause().size() == 3, "variables of the tautology occur");
+    check(is_model_of(solve(parsed.get_formula(), false), clauses, 3), "model covers the tautology");
+    check(is_model_of(solve(parsed.get_formula(), true), clauses, 3), "extended model covers the tautology");
+
+    // Write the cache, then load the formula from it.
+    Benchmark_reader(file_name, true);
+    Benchmark_reader cached(file_name, true);
+    check(cached.get_formula().get_variables_in_clause().size() == 3, "cache keeps the variables of the tautology");
+    check(is_model_of(solve(cached.get_formula(), true), clauses, 3), "model of the cached formula");
+    std::remove(file_name.c_str());
+    std::remove((file_name + ".cache").c_str());
+
+    // Compressed files cut in the middle must be reported, not solved as the formula read so far.
+#ifdef HAVE_ZLIB
+    write_file("truncated.cnf.gz", std::string("\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\x03\x2b\x50\x48\xce\x4b\x53\x30\x56\x30\xe2", 20));
+    check(fails_to_decompress("truncated.cnf.gz"), "truncated gzip file");
+    std::remove("truncated.cnf.gz");
+#endif
+#ifdef HAVE_LZMA
+    write_file("truncated.cnf.xz", std::string("\xfd\x37\x7a\x58\x5a\x00\x00\x04\xe6\xd6\xb4\x46\x02\x00\x21\x01\x16\x00\x00\x00\x74\x2f\xe5\xa3\x01\x00\x16\x70\x20\x63\x6e\x66\x20\x33\x20\x32\x0a\x31\x20\x2d", 40));
+    check(fails_to_decompress("truncated.cnf.xz"), "truncated xz file");
+    std::remove("truncated.cnf.xz");
+#endif
+#ifdef HAVE_BZIP2
+    write_file("truncated.cnf.bz2", std::string("\x42\x5a\x68\x39\x31\x41\x59\x26\x53\x59\xb7\x5e\x8c\xdd\x00\x00\x0b\x59\x80\x00\x10\x40\x02\x78\x00\x09\x01\x40\x00", 29));
+    check(fails_to_decompress("truncated.cnf.bz2"), "truncated bzip2 file");
+    std::remove("truncated.cnf.bz2");
+#endif
+
+    if(failures == 0){
+        std::cout << "ok\n";
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include "clause_arena.h"
+#include <stdexcept>
+
+Disjunction_clause Clause::to_disjunction_clause() const{
+    /*
+    Copy the literals of this clause into a stand-alone Disjunction_clause.
+    */
+    Disjunction_clause dc;
+    for(size_t i = 0; i != size(); ++i){
+        dc.add_literal((*this)[i]);
+    }
+    return dc;
+}
+
+Cref Clause_arena::allocate(const Disjunction_clause &dc, bool learned, unsigned lbd){
+    /*
+    Append a clause to the arena and return its reference. Empty clauses are never stored.
+    */
+    if(dc.size() == 0){
+        throw std::invalid_argument("Cannot store an empty clause in the clause arena.");
+    }
+
+    size_t words = Clause::header_words(learned) + dc.size();
+    if(memory.size() + words >= CREF_LIMIT){
+        throw std::length_error("Clause arena exceeds 31-bit clause references.");
+    }
+
+    Cref cr = static_cast<Cref>(memory.size());
+    memory.push_back(static_cast<uint32_t>(dc.size() << 4) | (learned ? 1 : 0));
+    if(learned){
+        memory.push_back(lbd);
+        memory.push_back(0);
+    }
+    for(size_t i = 0; i != dc.size(); ++i){
+        memory.push_back(dc[i].get_index());
+    }
+    return cr;
+}
+
+void Clause_arena::free(Cref cr){
+    Clause c = (*this)[cr];
+    c.mark_deleted();
+    wasted_words += words_of(c);
+}
+
+void Clause_arena::shrink(Cref cr, size_t n){
+    Clause c = (*this)[cr];
+    wasted_words += c.size() - n;
+    c.shrink(n);
+}
+
+Cref Clause_arena::relocate(Cref cr, Clause_arena &to){
+    /*
+    Move clause cr to the arena to. Later calls for the same clause return the reference of the existing copy.
+    */
+    Clause c = (*this)[cr];
+    if(c.is_relocated()){
+        return c.get_relocation();
+    }
+
+    Cref new_cr = static_cast<Cref>(to.memory.size());
+    to.memory.insert(to.memory.end(), memory.begin() + cr, memory.begin() + cr + words_of(c));
+    c.relocate_to(new_cr);
+    return new_cr;
+}
+
+void Clause_arena::swap(Clause_arena &other){
+    memory.swap(other.memory);
+    std::swap(wasted_words, other.wasted_words);
+}
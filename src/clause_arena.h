@@ -0,0 +1,92 @@
+/*
+    Contiguous storage for the clauses of a solver. Each clause is stored as a header word followed by its literals,
+    and is referred to by the 32-bit offset of its header.
+*/
+
+#ifndef CLAUSE_ARENA_H
+#define CLAUSE_ARENA_H
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <cstring>
+#include "literal.h"
+#include "disjunction_clause.h"
+
+// Reference to a clause: the offset of its header in the arena.
+typedef uint32_t Cref;
+const Cref CREF_UNDEFINED = 0xFFFFFFFF;
+// Clause offsets stay below CREF_LIMIT, so that the values above it can stand for something else than a clause.
+const Cref CREF_LIMIT = 0x80000000;
+
+class Clause{
+    // A view on a clause stored in a Clause_arena. It is invalidated when the arena allocates.
+    // Header layout: size << 4 | used << 3 | relocated << 2 | deleted << 1 | learned.
+    // Learned clauses have two more header words, their LBD and their activity, before the literals.
+public:
+    explicit Clause(uint32_t *d) : data(d) {}
+
+    size_t size() const {return data[0] >> 4;}
+    bool is_learned() const {return data[0] & 1;}
+    bool is_deleted() const {return data[0] & 2;}
+    bool is_relocated() const {return data[0] & 4;}
+    void mark_deleted() {data[0] |= 2;}
+    // Drop the literals from position n on. Use Clause_arena::shrink, which accounts for the freed words.
+    void shrink(size_t n) {data[0] = (data[0] & 15) | static_cast<uint32_t>(n << 4);}
+
+    // Set when a learned clause takes part in conflict analysis, cleared by the clause database reduction.
+    bool is_used() const {return data[0] & 8;}
+    void set_used(bool u) {data[0] = u ? (data[0] | 8) : (data[0] & ~uint32_t(8));}
+
+    // Only valid for learned clauses.
+    unsigned get_lbd() const {return data[1];}
+    void set_lbd(unsigned lbd) {data[1] = lbd;}
+    float get_activity() const {float a; std::memcpy(&a, &data[2], sizeof(a)); return a;}
+    void set_activity(float a) {std::memcpy(&data[2], &a, sizeof(a));}
+
+    // After relocation, the second header word holds the reference of the copy.
+    Cref get_relocation() const {return data[1];}
+    void relocate_to(Cref cr) {data[0] |= 4; data[1] = cr;}
+
+    Literal operator[](size_t i) const {return Literal::from_index(data[literals_offset() + i]);}
+    void set_literal(size_t i, const Literal &l) {data[literals_offset() + i] = l.get_index();}
+    void swap_literals(size_t i, size_t j) {std::swap(data[literals_offset() + i], data[literals_offset() + j]);}
+
+    Disjunction_clause to_disjunction_clause() const;
+
+    static size_t header_words(bool learned) {return learned ? 3 : 1;}
+
+private:
+    size_t literals_offset() const {return header_words(is_learned());}
+
+    uint32_t *data;
+};
+
+class Clause_arena{
+public:
+    explicit Clause_arena(size_t capacity = 0) : wasted_words(0) {memory.reserve(capacity);}
+
+    Cref allocate(const Disjunction_clause &dc, bool learned, unsigned lbd = 0);
+    Clause operator[](Cref cr) {return Clause(&memory[cr]);}
+
+    // Mark a clause as deleted. Its memory is reclaimed by the next garbage collection.
+    void free(Cref cr);
+    // Keep only the first n literals of clause cr. The rest is reclaimed by the next garbage collection.
+    void shrink(Cref cr, size_t n);
+
+    // Copy the clause cr into the arena to (once), and return its reference there.
+    Cref relocate(Cref cr, Clause_arena &to);
+
+    size_t size() const {return memory.size();}
+    size_t wasted() const {return wasted_words;}
+
+    void swap(Clause_arena &other);
+
+private:
+    static size_t words_of(const Clause &c) {return Clause::header_words(c.is_learned()) + c.size();}
+
+    std::vector<uint32_t> memory;
+    size_t wasted_words;
+};
+
+#endif
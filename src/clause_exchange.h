@@ -0,0 +1,153 @@
+/*
+    Lock-free exchange of short learned clauses between solvers running in parallel on the same formula.
+*/
+
+#ifndef CLAUSE_EXCHANGE_H
+#define CLAUSE_EXCHANGE_H
+
+#include "literal.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+template<typename T>
+class Bounded_mpmc_queue{
+    /*
+    Bounded multi-producer multi-consumer queue (D. Vyukov's ring buffer). Each cell carries a sequence number
+    that tells producers and consumers whether it is free or full for their current lap, so push and pop only
+    need one compare-and-swap on the shared position and never block. Capacity must be a power of two.
+    */
+public:
+    explicit Bounded_mpmc_queue(size_t capacity) : cells(new Cell[capacity]), mask(capacity - 1), enqueue_position(0), dequeue_position(0) {
+        if(capacity < 2 || (capacity & (capacity - 1)) != 0){
+            throw std::invalid_argument("Queue capacity must be a power of two.");
+        }
+        for(size_t i = 0; i != capacity; ++i){
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Return false, dropping value, if the queue is full.
+    bool push(const T &value){
+        size_t position = enqueue_position.load(std::memory_order_relaxed);
+        Cell *cell;
+        while(true){
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if(difference == 0){
+                if(enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+                    break;
+                }
+            }
+            else if(difference < 0){
+                return false;
+            }
+            else{
+                position = enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Return false if the queue is empty.
+    bool pop(T &value){
+        size_t position = dequeue_position.load(std::memory_order_relaxed);
+        Cell *cell;
+        while(true){
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if(difference == 0){
+                if(dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+                    break;
+                }
+            }
+            else if(difference < 0){
+                return false;
+            }
+            else{
+                position = dequeue_position.load(std::memory_order_relaxed);
+            }
+        }
+        value = cell->data;
+        cell->sequence.store(position + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    struct Cell{
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    // Keep the two positions on separate cache lines, producers and consumers update them independently.
+    char padding0[64];
+    std::atomic<size_t> enqueue_position;
+    char padding1[64];
+    std::atomic<size_t> dequeue_position;
+    char padding2[64];
+};
+
+class Shared_clause{
+    // A learned clause in transit between solvers. Fixed size, so that queue cells never allocate.
+public:
+    static const unsigned MAX_SIZE = 8;
+
+    Shared_clause() : size(0), lbd(0) {}
+
+    // Hash independent of the order of the literals, used to filter duplicates.
+    uint64_t hash() const{
+        uint32_t codes[MAX_SIZE];
+        for(unsigned i = 0; i != size; ++i){
+            codes[i] = literals[i].get_index();
+        }
+        std::sort(codes, codes + size);
+        uint64_t h = 0xCBF29CE484222325ULL;
+        for(unsigned i = 0; i != size; ++i){
+            h = (h ^ codes[i]) * 0x100000001B3ULL;
+        }
+        return (h ^ size) * 0x100000001B3ULL;
+    }
+
+    unsigned size;
+    unsigned lbd;
+    Literal literals[MAX_SIZE];
+};
+
+class Clause_exchange{
+    /*
+    One queue per solver. A clause exported by a solver is pushed to the queues of all other solvers, and each
+    solver imports from its own queue. Queues are bounded: when one is full, clauses for it are dropped.
+    */
+public:
+    explicit Clause_exchange(size_t num_solvers, size_t capacity = 1 << 14){
+        for(size_t i = 0; i != num_solvers; ++i){
+            queues.emplace_back(new Bounded_mpmc_queue<Shared_clause>(capacity));
+        }
+    }
+
+    void export_clause(size_t from, const Shared_clause &c){
+        for(size_t i = 0; i != queues.size(); ++i){
+            if(i != from){
+                queues[i]->push(c);
+            }
+        }
+    }
+
+    bool import_clause(size_t to, Shared_clause &c){
+        return queues[to]->pop(c);
+    }
+
+private:
+    std::vector<std::unique_ptr<Bounded_mpmc_queue<Shared_clause>>> queues;
+};
+
+#endif
@@ -0,0 +1,196 @@
+#include "cnf_cache.h"
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char Cnf_cache::MAGIC[8] = {'S', 'A', 'T', 'C', 'N', 'F', 'C', '1'};
+
+Cnf_cache::Cnf_cache(const std::string &file_name) : data(nullptr), length(0){
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if(fd < 0){
+        throw std::invalid_argument("Cannot open file " + file_name);
+    }
+    struct stat st;
+    if(fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(Header)){
+        void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(p != MAP_FAILED){
+            data = p;
+            length = st.st_size;
+        }
+    }
+    ::close(fd);
+}
+
+Cnf_cache::~Cnf_cache(){
+    if(data){
+        munmap(data, length);
+    }
+}
+
+const Cnf_cache::Header* Cnf_cache::header() const{
+    return static_cast<const Header*>(data);
+}
+
+const uint64_t* Cnf_cache::offsets() const{
+    return reinterpret_cast<const uint64_t*>(static_cast<const char*>(data) + sizeof(Header));
+}
+
+const uint32_t* Cnf_cache::literals() const{
+    return reinterpret_cast<const uint32_t*>(offsets() + header()->num_clauses + 1);
+}
+
+const uint32_t* Cnf_cache::unconstrained() const{
+    return literals() + header()->num_literals;
+}
+
+bool Cnf_cache::is_valid() const{
+    /*
+    Check the magic, the version, that the file size matches the counts in the header, that the clause offsets are
+    increasing and end at the number of literals, and that every literal and unconstrained variable belongs to one of
+    the variables.
+    */
+    if(!data){
+        return false;
+    }
+    const Header *h = header();
+    if(std::memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->version != VERSION){
+        return false;
+    }
+    uint64_t max_entries = length / sizeof(uint32_t);
+    if(h->num_clauses >= max_entries || h->num_literals >= max_entries || h->num_unconstrained >= max_entries){
+        return false;
+    }
+    uint64_t num_entries = h->num_literals + h->num_unconstrained;
+    if(sizeof(Header) + (h->num_clauses + 1) * sizeof(uint64_t) + num_entries * sizeof(uint32_t) != length){
+        return false;
+    }
+    const uint64_t *o = offsets();
+    if(o[0] != 0 || o[h->num_clauses] != h->num_literals){
+        return false;
+    }
+    for(uint64_t i = 0; i != h->num_clauses; ++i){
+        if(o[i] > o[i + 1]){
+            return false;
+        }
+    }
+    const uint32_t *lits = literals();
+    for(uint64_t i = 0; i != h->num_literals; ++i){
+        if(lits[i] >= 2 * h->num_variables){
+            return false;
+        }
+    }
+    const uint32_t *vars = unconstrained();
+    for(uint64_t i = 0; i != h->num_unconstrained; ++i){
+        if(vars[i] >= h->num_variables){
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t Cnf_cache::get_source_hash() const{
+    return header()->source_hash;
+}
+
+Conjunction_clause Cnf_cache::to_formula() const{
+    /*
+    Build the formula stored in this cache.
+    Assumption: is_valid().
+    */
+    static_assert(sizeof(Literal) == sizeof(uint32_t), "Literal must be stored as its 32-bit code.");
+    const Header *h = header();
+    const uint64_t *o = offsets();
+    const Literal *lits = reinterpret_cast<const Literal*>(literals());
+
+    Conjunction_clause cnf;
+    cnf.reserve_variables(h->num_variables);
+    cnf.reserve_clauses(h->num_clauses);
+    for(uint64_t i = 0; i != h->num_clauses; ++i){
+        cnf.add_clause(Disjunction_clause(std::vector<Literal>(lits + o[i], lits + o[i + 1])));
+    }
+    const uint32_t *vars = unconstrained();
+    for(uint64_t i = 0; i != h->num_unconstrained; ++i){
+        cnf.add_unconstrained_variable(Variable(vars[i]));
+    }
+    return cnf;
+}
+
+void Cnf_cache::write(const std::string &file_name, const Conjunction_clause &cnf, uint64_t source_hash){
+    /*
+    The cache is written to a temporary file that is renamed over file_name, so readers never see a partial cache.
+    */
+    Header h;
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.num_variables = cnf.get_num_variables();
+    h.num_clauses = cnf.size();
+    h.num_literals = 0;
+    h.num_unconstrained = cnf.get_unconstrained_variables().size();
+    h.source_hash = source_hash;
+
+    std::vector<uint64_t> clause_offsets;
+    clause_offsets.reserve(cnf.size() + 1);
+    clause_offsets.push_back(0);
+    for(auto &dc : cnf.get_clauses()){
+        h.num_literals += dc.size();
+        clause_offsets.push_back(h.num_literals);
+    }
+
+    std::string temporary_name = file_name + ".tmp";
+    std::ofstream ofs(temporary_name, std::ios::binary | std::ios::trunc);
+    if(!ofs){
+        throw std::runtime_error("Cannot write cache " + file_name);
+    }
+    ofs.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    ofs.write(reinterpret_cast<const char*>(clause_offsets.data()), clause_offsets.size() * sizeof(uint64_t));
+    for(auto &dc : cnf.get_clauses()){
+        ofs.write(reinterpret_cast<const char*>(dc.get_literals().data()), dc.size() * sizeof(Literal));
+    }
+    for(auto &v : cnf.get_unconstrained_variables()){
+        uint32_t index = v.get_index();
+        ofs.write(reinterpret_cast<const char*>(&index), sizeof(index));
+    }
+    ofs.close();
+    if(!ofs || std::rename(temporary_name.c_str(), file_name.c_str()) != 0){
+        std::remove(temporary_name.c_str());
+        throw std::runtime_error("Cannot write cache " + file_name);
+    }
+}
+
+uint64_t Cnf_cache::hash_file(const std::string &file_name){
+    /*
+    64-bit FNV-1a over 8-byte words (the tail is zero padded), followed by the file length.
+    */
+    std::unique_ptr<std::FILE, int(*)(std::FILE*)> file(std::fopen(file_name.c_str(), "rb"), &std::fclose);
+    if(!file){
+        throw std::invalid_argument("Cannot open file " + file_name);
+    }
+    const uint64_t prime = 0x100000001B3ULL;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    uint64_t total = 0;
+    std::vector<char> buffer(1 << 20);
+    size_t n;
+    while((n = std::fread(buffer.data(), 1, buffer.size(), file.get())) != 0){
+        total += n;
+        for(size_t i = 0; i < n; i += sizeof(uint64_t)){
+            uint64_t word = 0;
+            std::memcpy(&word, buffer.data() + i, std::min(sizeof(uint64_t), n - i));
+            hash = (hash ^ word) * prime;
+        }
+    }
+    return (hash ^ total) * prime;
+}
+
+bool Cnf_cache::is_cache_file(const std::string &file_name){
+    std::ifstream ifs(file_name, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    return ifs.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
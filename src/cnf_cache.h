@@ -0,0 +1,61 @@
+#ifndef CNF_CACHE_H
+#define CNF_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include "conjunction_clause.h"
+
+class Cnf_cache{
+    /*
+    A pre-parsed formula stored in binary form and memory-mapped for reading.
+
+    Layout (native byte order):
+        header: magic "SATCNFC1", version, number of variables, number of clauses, number of literals, number of
+                unconstrained variables, and a hash of the source file the cache was built from;
+        offsets: number of clauses + 1 uint64, clause i occupies literals [offsets[i], offsets[i+1]);
+        literals: the literal codes (Literal::get_index()) of all clauses, one uint32 each;
+        unconstrained: the indices of the unconstrained variables of the formula, one uint32 each.
+    */
+public:
+    // Map file_name. Throw if the file cannot be opened; use is_valid() to check its content.
+    explicit Cnf_cache(const std::string &file_name);
+    ~Cnf_cache();
+    Cnf_cache(const Cnf_cache&) = delete;
+    Cnf_cache& operator=(const Cnf_cache&) = delete;
+
+    // Whether the mapped file is a well-formed cache of this version.
+    bool is_valid() const;
+    uint64_t get_source_hash() const;
+    Conjunction_clause to_formula() const;
+
+    // Write cnf to file_name as a cache of a source whose hash is source_hash.
+    static void write(const std::string &file_name, const Conjunction_clause &cnf, uint64_t source_hash);
+    // Hash of the raw bytes of a file, used to detect caches that are older than their source.
+    static uint64_t hash_file(const std::string &file_name);
+    // Whether file_name starts with the cache magic.
+    static bool is_cache_file(const std::string &file_name);
+
+private:
+    struct Header{
+        char magic[8];
+        uint64_t version;
+        uint64_t num_variables;
+        uint64_t num_clauses;
+        uint64_t num_literals;
+        uint64_t num_unconstrained;
+        uint64_t source_hash;
+    };
+
+    static const char MAGIC[8];
+    static const uint64_t VERSION = 2;
+
+    const Header* header() const;
+    const uint64_t* offsets() const;
+    const uint32_t* literals() const;
+    const uint32_t* unconstrained() const;
+
+    void *data;
+    size_t length;
+};
+
+#endif
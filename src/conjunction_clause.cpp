@@ -1,4 +1,52 @@
 #include "conjunction_clause.h"
+#include <sstream>
+#include <utility>
+
+Conjunction_clause::Conjunction_clause(std::vector<Disjunction_clause> c) : num_variables(0){
+    for(auto &dc : c){
+        add_clause(dc);
+    }
+}
+
+void Conjunction_clause::add_clause(Disjunction_clause c){
+    for(size_t i = 0; i != c.size(); ++i){
+        reserve_variables(c[i].get_variable().get_index() + 1);
+    }
+    this->clauses.push_back(std::move(c));
+}
+
+void Conjunction_clause::add_unconstrained_variable(const Variable &v){
+    reserve_variables(v.get_index() + 1);
+    this->unconstrained_variables.push_back(v);
+}
+
+void Conjunction_clause::reserve_variables(size_t n){
+    /*
+    Make sure variables 0 .. n-1 exist in this formula.
+    */
+    if(n > num_variables){
+        num_variables = n;
+    }
+}
+
+void Conjunction_clause::set_variable_name(const Variable &v, const std::string &name){
+    if(v.get_index() >= variable_names.size()){
+        variable_names.resize(v.get_index() + 1);
+    }
+    variable_names[v.get_index()] = name;
+}
+
+std::string Conjunction_clause::get_variable_name(const Variable &v) const{
+    /*
+    Return the name of v. Variables without a recorded name are printed with their default name.
+    */
+    if(v.get_index() < variable_names.size() && !variable_names[v.get_index()].empty()){
+        return variable_names[v.get_index()];
+    }
+    std::ostringstream oss;
+    oss << v;
+    return oss.str();
+}
 
 std::ostream& operator<<(std::ostream &os, const Conjunction_clause &cc){
     if(!cc.clauses.size()){
@@ -11,16 +59,23 @@ std::ostream& operator<<(std::ostream &os, const Conjunction_clause &cc){
     return os;
 }
 
-std::vector<Variable> Conjunction_clause::get_variables_in_clause(){
+std::vector<Variable> Conjunction_clause::get_variables_in_clause() const{
     std::vector<Variable> v;
-    for(auto cl : clauses){
-        for(auto l : cl.get_literals()){
-            // if l.variable not in v
-            auto iter = std::find_if(v.begin(), v.end(), [l](Variable v) -> bool {return l.get_variable() == v;});
-            if(iter == v.end()){
-                v.push_back(l.get_variable());
+    std::vector<bool> seen(num_variables, false);
+    for(auto &cl : clauses){
+        for(size_t i = 0; i != cl.size(); ++i){
+            Variable var = cl[i].get_variable();
+            if(!seen[var.get_index()]){
+                seen[var.get_index()] = true;
+                v.push_back(var);
             }
         }
     }
+    for(auto &var : unconstrained_variables){
+        if(!seen[var.get_index()]){
+            seen[var.get_index()] = true;
+            v.push_back(var);
+        }
+    }
     return v;
 }
@@ -2,13 +2,14 @@
 #define CONJUNCTION_CLAUSE_H
 
 #include <vector>
+#include <string>
 #include <iostream>
 #include "disjunction_clause.h"
 
 class Conjunction_clause{
 friend std::ostream& operator<<(std::ostream &os, const Conjunction_clause &cc);
 public:
-    Conjunction_clause(std::vector<Disjunction_clause> c = std::vector<Disjunction_clause>()) : clauses(c) {}
+    Conjunction_clause(std::vector<Disjunction_clause> c = std::vector<Disjunction_clause>());
 
     std::vector<Disjunction_clause>::iterator begin(){
         return clauses.begin();
@@ -18,19 +19,49 @@ public:
         return clauses.end();
     }
 
-    std::vector<Disjunction_clause> get_clauses(){
+    const std::vector<Disjunction_clause>& get_clauses() const{
         return this->clauses;
     }
 
-    void add_clause(Disjunction_clause c){
-        this->clauses.push_back(c);
+    void add_clause(Disjunction_clause c);
+
+    size_t size() const{
+        return this->clauses.size();
+    }
+
+    Disjunction_clause& operator[](size_t i){
+        return this->clauses[i];
+    }
+
+    // Variables of the clauses and the unconstrained variables, each once.
+    std::vector<Variable> get_variables_in_clause() const;
+
+    // Variables that occur in the input without constraining it, e.g. only in tautologies dropped by the reader.
+    // They are still part of the formula, and of its models.
+    void add_unconstrained_variable(const Variable &v);
+    const std::vector<Variable>& get_unconstrained_variables() const{
+        return this->unconstrained_variables;
+    }
+
+    // Variables are indexed from 0 to get_num_variables() - 1.
+    size_t get_num_variables() const{
+        return this->num_variables;
+    }
+
+    void reserve_variables(size_t n);
+    void reserve_clauses(size_t n){
+        this->clauses.reserve(n);
     }
 
-    std::vector<Variable> get_variables_in_clause();
+    // Side table of variable names, only used for printing.
+    void set_variable_name(const Variable &v, const std::string &name);
+    std::string get_variable_name(const Variable &v) const;
 
 private:
     std::vector<Disjunction_clause> clauses;
-    
+    size_t num_variables;
+    std::vector<Variable> unconstrained_variables;
+    std::vector<std::string> variable_names;
 
 };
 
@@ -0,0 +1,148 @@
+#include "cube_and_conquer.h"
+#include "lookahead.h"
+#include "clause_exchange.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+class Work_queue{
+    // Cubes owned by one worker. The owner takes from the back, thieves take from the front.
+public:
+    void push(size_t cube){
+        std::lock_guard<std::mutex> lock(mutex);
+        cubes.push_back(cube);
+    }
+
+    bool pop(size_t &cube){
+        std::lock_guard<std::mutex> lock(mutex);
+        if(cubes.empty()){
+            return false;
+        }
+        cube = cubes.back();
+        cubes.pop_back();
+        return true;
+    }
+
+    bool steal(size_t &cube){
+        std::lock_guard<std::mutex> lock(mutex);
+        if(cubes.empty()){
+            return false;
+        }
+        cube = cubes.front();
+        cubes.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<size_t> cubes;
+};
+
+}
+
+Cube_and_conquer::Cube_and_conquer(const Conjunction_clause &c, unsigned n, unsigned d, const Solver_options &o, bool v) : cnf(c), num_workers(std::max(1u, n)), depth(d), options(o), verbose(v), num_cubes(0), cpu_seconds(0) {
+    if(depth == 0){
+        // About 16 cubes per worker, so that stealing can even out cubes of very different hardness.
+        depth = 4;
+        while((1u << depth) < 16 * num_workers){
+            ++depth;
+        }
+    }
+}
+
+Solve_result Cube_and_conquer::solve(){
+    /*
+    Generate the cubes in the calling thread, then deal them round-robin to the workers. Each worker solves its
+    cubes under assumptions with its own Solver, keeping learned clauses from one cube to the next, and steals
+    from the other workers when it runs out. Workers share short learned clauses, which hold regardless of the
+    cubes. The first satisfiable cube stops all workers; the formula is unsatisfiable if every cube is.
+    */
+    double cpu_start = thread_cpu_seconds();
+    std::vector<std::vector<Literal>> cubes;
+    {
+        Solver splitter(cnf, verbose, options);
+        cubes = Lookahead(splitter).generate_cubes(depth);
+    }
+    num_cubes = cubes.size();
+    cpu_seconds = thread_cpu_seconds() - cpu_start;
+    if(cubes.empty()){
+        return Solve_result::Unsatisfiable;
+    }
+
+    std::vector<Work_queue> queues(num_workers);
+    for(size_t i = 0; i != cubes.size(); ++i){
+        queues[i % num_workers].push(i);
+    }
+
+    std::atomic<bool> stop(false);
+    std::mutex result_mutex;
+    Solve_result result = Solve_result::Unsatisfiable;
+    std::exception_ptr error;
+    std::vector<double> thread_cpu(num_workers, 0);
+    Clause_exchange exchange(num_workers);
+
+    auto work = [&](size_t w){
+        double worker_cpu_start = thread_cpu_seconds();
+        try{
+            Solver_options o = options;
+            o.seed = options.seed + w;
+            Solver s(cnf, verbose, o);
+            s.set_stop_flag(&stop);
+            s.set_clause_exchange(&exchange, w);
+
+            size_t cube;
+            while(!stop){
+                bool has_cube = queues[w].pop(cube);
+                for(size_t k = 1; k != num_workers && !has_cube; ++k){
+                    has_cube = queues[(w + k) % num_workers].steal(cube);
+                }
+                if(!has_cube){
+                    break;
+                }
+
+                Solve_result r = s.solve(cubes[cube]);
+                if(r == Solve_result::Satisfiable){
+                    std::lock_guard<std::mutex> lock(result_mutex);
+                    if(result != Solve_result::Satisfiable){
+                        result = r;
+                        model = s.get_model();
+                    }
+                    stop = true;
+                }
+                else if(r == Solve_result::Unknown){
+                    std::lock_guard<std::mutex> lock(result_mutex);
+                    if(result != Solve_result::Satisfiable){
+                        result = r;
+                    }
+                }
+            }
+        }
+        catch(...){
+            std::lock_guard<std::mutex> lock(result_mutex);
+            if(!error){
+                error = std::current_exception();
+            }
+            stop = true;
+        }
+        thread_cpu[w] = thread_cpu_seconds() - worker_cpu_start;
+    };
+
+    std::vector<std::thread> threads;
+    for(size_t w = 0; w != num_workers; ++w){
+        threads.emplace_back(work, w);
+    }
+    for(size_t w = 0; w != num_workers; ++w){
+        threads[w].join();
+        cpu_seconds += thread_cpu[w];
+    }
+
+    if(result != Solve_result::Satisfiable && error){
+        std::rethrow_exception(error);
+    }
+    return result;
+}
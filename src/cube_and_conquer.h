@@ -0,0 +1,39 @@
+/*
+    Cube_and_conquer class. Splits a formula into cubes by lookahead, then solves the cubes as assumptions with a
+    pool of work-stealing worker threads.
+*/
+
+#ifndef CUBE_AND_CONQUER_H
+#define CUBE_AND_CONQUER_H
+
+#include "conjunction_clause.h"
+#include "solver.h"
+#include "solver_options.h"
+#include <vector>
+#include <memory>
+
+class Cube_and_conquer{
+public:
+    // depth is the number of branching decisions per cube; 0 chooses it from the number of workers. c is only
+    // read, and must outlive solve().
+    Cube_and_conquer(const Conjunction_clause &c, unsigned num_workers, unsigned depth, const Solver_options &o, bool v = false);
+    Solve_result solve();
+
+    // Valid after solve() returned Satisfiable.
+    std::vector<Literal> get_model() const {return model;}
+    size_t get_num_cubes() const {return num_cubes;}
+    // CPU time used by cube generation and all worker threads of the last solve().
+    double get_cpu_seconds() const {return cpu_seconds;}
+
+private:
+    const Conjunction_clause &cnf;
+    unsigned num_workers;
+    unsigned depth;
+    Solver_options options;
+    bool verbose;
+    std::vector<Literal> model;
+    size_t num_cubes;
+    double cpu_seconds;
+};
+
+#endif
@@ -8,8 +8,8 @@
 
 void dump_debug_info(const Solver &s){
     std::cout << "Current assignment:";
-    for(auto p : s.assignment){
-        std::cout << p.first << " " << p.second << std::endl;
+    for(auto &l : s.trail){
+        std::cout << l << "@" << s.levels[l.get_variable().get_index()] << std::endl;
     }
 }
 
@@ -1,5 +1,4 @@
 #include "disjunction_clause.h"
-#include "solver_exception.h"
 #include <algorithm>
 
 std::ostream& operator<<(std::ostream &os, const Disjunction_clause &dc){
@@ -13,14 +12,43 @@ std::ostream& operator<<(std::ostream &os, const Disjunction_clause &dc){
     return os;
 }
 
-Literal Disjunction_clause::propagate_clause(Disjunction_clause dc, std::vector<std::pair<Literal, Disjunction_clause>> assignment){
+bool Disjunction_clause::operator==(const Disjunction_clause &d) const{
+    if(literals.size() != d.literals.size()){
+        return false;
+    }
+    if(std::equal(literals.begin(), literals.end(), d.literals.begin())){
+        return true;
+    }
+    auto by_index = [](const Literal &a, const Literal &b){return a.get_index() < b.get_index();};
+    std::vector<Literal> mine(literals), theirs(d.literals);
+    std::sort(mine.begin(), mine.end(), by_index);
+    std::sort(theirs.begin(), theirs.end(), by_index);
+    return mine == theirs;
+}
+
+bool Disjunction_clause::normalize(){
+    /*
+    A literal and its negation have adjacent indices, so after sorting a tautology shows up as two neighbours.
+    */
+    std::sort(literals.begin(), literals.end(), [](const Literal &a, const Literal &b){return a.get_index() < b.get_index();});
+    literals.erase(std::unique(literals.begin(), literals.end()), literals.end());
+    for(size_t i = 1; i < literals.size(); ++i){
+        if(literals[i] == !literals[i - 1]){
+            return false;
+        }
+    }
+    return true;
+}
+
+Propagation_status Disjunction_clause::propagate_clause(const Disjunction_clause &dc, const std::vector<std::pair<Literal, Disjunction_clause>> &assignment, Literal &propagated){
     /*
     Propagate literals for a disjunction clause based on the current assignment.
-    Return the propagated literal.
+    Return Unit and store the implied literal in propagated if exactly one literal is left unassigned. Otherwise
+    return whether the clause is satisfied, falsified (Conflict) or still has several unassigned literals.
     */
     
     std::vector<Literal> literals_in_clause = dc.literals;
-    for(auto dec : assignment){
+    for(auto &dec : assignment){
         Literal lit = dec.first;
         std::vector<Literal>::iterator iter = std::find(literals_in_clause.begin(), literals_in_clause.end(), !lit);
         if(iter != literals_in_clause.end()){
@@ -31,24 +59,25 @@ Literal Disjunction_clause::propagate_clause(Disjunction_clause dc, std::vector<
         iter = std::find(literals_in_clause.begin(), literals_in_clause.end(), lit);
         if(iter != literals_in_clause.end()){
             //if lit is in clause, we cannot propagate from this clause.
-            throw TrueClauseException("This clause is evaluated to true.");
+            return Propagation_status::Satisfied;
         }
     }
 
     if(literals_in_clause.size() == 0){
-        throw ConflictClauseException("Propagation leads to Conflict.");
+        return Propagation_status::Conflict;
     }
     else if(literals_in_clause.size() == 1){
-        return literals_in_clause.back();
+        propagated = literals_in_clause.back();
+        return Propagation_status::Unit;
     }
     else{
         // more than 1 unassigned lit in this clause, cannot propagate.
-        throw NoLiteralToPropagateException("Cannot propagate anymore.");
+        return Propagation_status::Unresolved;
     }
 
 }
 
-Disjunction_clause Disjunction_clause::resolve(Disjunction_clause dc1, Disjunction_clause dc2, Variable v){
+Disjunction_clause Disjunction_clause::resolve(const Disjunction_clause &dc1, const Disjunction_clause &dc2, Variable v){
     // std::cout << "Try to resolve " << dc1 << " and " << dc2 << " on variable " << v << std::endl;
     
     Disjunction_clause dc;
@@ -60,7 +89,7 @@ Disjunction_clause Disjunction_clause::resolve(Disjunction_clause dc1, Disjuncti
 
     for(auto lit : dc2.get_literals()){
         if(lit.get_variable() != v){
-            auto existing_literals = dc.get_literals();
+            auto &existing_literals = dc.get_literals();
             auto iter = std::find(existing_literals.begin(), existing_literals.end(), lit);
             if(iter != existing_literals.end()){
                 // std::cout << *iter << " = " << lit << " is " << (*iter == lit) << " in " << dc << std::endl;
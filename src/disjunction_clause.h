@@ -2,23 +2,24 @@
 #define DISJUNCTION_CLAUSE_H
 
 #include <vector>
+#include <cstdint>
 #include <iostream>
 #include <tuple>
+#include <utility>
 #include "literal.h"
 
 class ClauseHash;
 
+// Outcome of evaluating a clause under a partial assignment.
+enum class Propagation_status { Satisfied, Unit, Unresolved, Conflict };
+
 class Disjunction_clause{
 friend std::ostream& operator<<(std::ostream &os, const Disjunction_clause &dc);
 friend class ClauseHash;
 public:
-    explicit Disjunction_clause(std::vector<Literal> v = std::vector<Literal>()) : literals(v) {}
-
-    std::vector<Literal> get_literals(){
-        return this->literals;
-    }
+    explicit Disjunction_clause(std::vector<Literal> v = std::vector<Literal>()) : literals(std::move(v)) {}
 
-    const std::vector<Literal> get_literals() const{
+    const std::vector<Literal>& get_literals() const{
         return this->literals;
     }
 
@@ -26,21 +27,31 @@ public:
         this->literals.push_back(v);
     }
 
-    bool operator==(const Disjunction_clause &d) const{
-        if(literals.size() != d.literals.size()){
-            return false;
-        }
+    size_t size() const{
+        return this->literals.size();
+    }
 
-        for(size_t i = 0; i != literals.size(); ++i){
-            if(literals[i] != d.literals[i]){
-                return false;
-            }
-        }
-        return true;
+    void resize(size_t n){
+        this->literals.resize(n);
+    }
+
+    // Positional access, used by the watched-literal scheme to keep the two watches at positions 0 and 1.
+    Literal& operator[](size_t i){
+        return this->literals[i];
+    }
+
+    const Literal& operator[](size_t i) const{
+        return this->literals[i];
     }
 
-    static Disjunction_clause resolve(Disjunction_clause dc1, Disjunction_clause dc2, Variable v);
-    static Literal propagate_clause(Disjunction_clause dc, std::vector<std::pair<Literal, Disjunction_clause>> assignment);
+    // Clauses are equal if they contain the same literals (with the same multiplicities), in any order.
+    bool operator==(const Disjunction_clause &d) const;
+
+    // Sort the literals by index and remove duplicate literals. Return false if the clause is a tautology.
+    bool normalize();
+
+    static Disjunction_clause resolve(const Disjunction_clause &dc1, const Disjunction_clause &dc2, Variable v);
+    static Propagation_status propagate_clause(const Disjunction_clause &dc, const std::vector<std::pair<Literal, Disjunction_clause>> &assignment, Literal &propagated);
 
 
 private:
@@ -48,13 +59,25 @@ private:
 };
 
 class ClauseHash{
+    /*
+    Hash independent of the order of the literals, consistent with Disjunction_clause::operator==. Every literal
+    is mixed on its own (splitmix64 finalizer) before the results are added, so clauses sharing most of their
+    literals still get unrelated hashes.
+    */
 public:
     size_t operator()(const Disjunction_clause &d) const{
-        size_t hashValue = 0;
+        uint64_t sum = d.literals.size();
         for(size_t i = 0; i != d.literals.size(); ++i){
-            hashValue ^= (LiteralHash()(d.literals[i]) << i);
+            sum += mix(LiteralHash()(d.literals[i]) + 0x9E3779B97F4A7C15ULL);
         }
-        return hashValue;
+        return static_cast<size_t>(mix(sum));
+    }
+
+private:
+    static uint64_t mix(uint64_t x){
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
     }
 };
 
@@ -0,0 +1,57 @@
+#include "evsids_heuristic.h"
+
+EVSIDS_heuristic::EVSIDS_heuristic(const std::vector<Variable> &vars, size_t num_variables, double d) : activity(num_variables, 0.0), increment(1.0), decay(d), order(Activity_compare(activity)) {
+    for(auto &v : vars){
+        order.insert(v.get_index());
+    }
+}
+
+Variable EVSIDS_heuristic::choose_decide_variable(const std::vector<Value> &values){
+    while(!order.empty()){
+        Variable v(order.top());
+        if(values[Literal(v).get_index()] == Value::Unassigned){
+            return v;
+        }
+        order.pop();
+    }
+    return Variable();
+}
+
+void EVSIDS_heuristic::bump(const Variable &v){
+    /*
+    Add the current increment to the activity of v. Rescale every activity when they get too large.
+    */
+    uint32_t index = v.get_index();
+    activity[index] += increment;
+    if(activity[index] > 1e100){
+        for(auto &a : activity){
+            a *= 1e-100;
+        }
+        increment *= 1e-100;
+    }
+    if(order.contains(index)){
+        order.increase(index);
+    }
+}
+
+void EVSIDS_heuristic::bump_variables(const std::vector<Variable> &vars){
+    for(auto &v : vars){
+        bump(v);
+    }
+    increment /= decay;
+}
+
+void EVSIDS_heuristic::unassign(const Variable &v){
+    if(!order.contains(v.get_index())){
+        order.insert(v.get_index());
+    }
+}
+
+void EVSIDS_heuristic::add_variable(const Variable &v){
+    if(v.get_index() >= activity.size()){
+        activity.resize(v.get_index() + 1, 0.0);
+    }
+    if(!order.contains(v.get_index())){
+        order.insert(v.get_index());
+    }
+}
@@ -0,0 +1,39 @@
+/*
+    Exponential VSIDS. Each variable has an activity that is bumped when the variable takes part in a conflict. The
+    bump amount grows geometrically after each conflict, which decays older activities without touching them.
+*/
+
+#ifndef EVSIDS_HEURISTIC_H
+#define EVSIDS_HEURISTIC_H
+
+#include "heuristic.h"
+#include "indexed_heap.h"
+
+class EVSIDS_heuristic : public Heuristic{
+public:
+    EVSIDS_heuristic(const std::vector<Variable> &vars, size_t num_variables, double decay = 0.95);
+
+    Variable choose_decide_variable(const std::vector<Value> &values) override;
+    void bump_variables(const std::vector<Variable> &vars) override;
+    void unassign(const Variable &v) override;
+    void add_variable(const Variable &v) override;
+
+private:
+    class Activity_compare{
+    public:
+        explicit Activity_compare(const std::vector<double> &a) : activity(&a) {}
+        bool operator()(uint32_t a, uint32_t b) const {return (*activity)[a] > (*activity)[b];}
+    private:
+        const std::vector<double> *activity;
+    };
+
+    void bump(const Variable &v);
+
+    std::vector<double> activity;
+    double increment;
+    double decay;
+    // Candidates for decisions. Assigned variables are removed lazily when they reach the top.
+    Indexed_heap<Activity_compare> order;
+};
+
+#endif
@@ -0,0 +1,14 @@
+#include "heuristic.h"
+#include "evsids_heuristic.h"
+#include "vmtf_heuristic.h"
+#include <stdexcept>
+
+std::unique_ptr<Heuristic> Heuristic::create(const std::string &name, const std::vector<Variable> &vars, size_t num_variables){
+    if(name == "evsids"){
+        return std::unique_ptr<Heuristic>(new EVSIDS_heuristic(vars, num_variables));
+    }
+    if(name == "vmtf"){
+        return std::unique_ptr<Heuristic>(new VMTF_heuristic(vars, num_variables));
+    }
+    throw std::invalid_argument("Unknown decision heuristic " + name);
+}
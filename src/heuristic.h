@@ -1,22 +1,40 @@
+/*
+    Interface of decision heuristics. The solver reports which variables took part in each conflict and which
+    variables got unassigned; the heuristic picks the next variable to decide on.
+*/
+
 #ifndef HEURISTIC_H
 #define HEURISTIC_H
 
 #include "literal.h"
+#include "value.h"
 #include <vector>
-#include <algorithm>
+#include <memory>
+#include <string>
 
 class Heuristic{
-    // define sort method
 public:
-    Literal choose_decide_literal(std::vector<Variable> v){
-        std::sort(v.begin(), v.end(), [](Literal va, Literal vb) -> bool {return va.get_variable().get_name() < vb.get_variable().get_name();});
-        return v.front();
-    }
-private:
+    virtual ~Heuristic() {}
+
+    // Return an unassigned variable to decide on, or an undefined variable if every variable is assigned.
+    // values holds the value of each literal, indexed by literal.
+    virtual Variable choose_decide_variable(const std::vector<Value> &values) = 0;
+
+    // Called once per conflict with the variables seen during conflict analysis.
+    virtual void bump_variables(const std::vector<Variable> &vars) = 0;
+
+    // Called for each variable that becomes unassigned when backtracking.
+    virtual void unassign(const Variable &v) = 0;
+
+    // Make v a candidate for decisions, when it first occurs in a clause added after creation. v may be beyond the
+    // variables the heuristic was created for.
+    virtual void add_variable(const Variable &v) = 0;
 
+    // Create a heuristic by name ("evsids" or "vmtf") over the given variables.
+    static std::unique_ptr<Heuristic> create(const std::string &name, const std::vector<Variable> &vars, size_t num_variables);
 };
 
 
 
 
-#endif
\ No newline at end of file
+#endif
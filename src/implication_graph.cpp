@@ -8,8 +8,8 @@
 
 Implication_graph::Implication_graph() : all_nodes(std::unordered_set<std::shared_ptr<Node>, PtrToNodeHash, PtrToNodeCompare>()), 
                                          all_edges(std::unordered_multimap<std::shared_ptr<Node>, std::pair<std::shared_ptr<Node>, Disjunction_clause>, PtrToNodeHash, PtrToNodeCompare>()),
-                                         root(create_new_node(Node(Literal(Variable("root"), true), 0))), 
-                                         conflict((create_new_node(Node(Literal(Variable("conflict"), true), 0)))) {}
+                                         root(create_new_node(Node(Literal(Variable(), true), 0))), 
+                                         conflict((create_new_node(Node(Literal(Variable(), false), 0)))) {}
 
 
 std::shared_ptr<Node> Implication_graph::create_new_node(const Node &n){
@@ -224,7 +224,7 @@ size_t Implication_graph::find_decision_level_of_variable(const Variable &v){
             return node_ptr->decision_level;
         }
     }
-    throw std::runtime_error("No node corresponds to variable " + v.get_name());
+    throw std::runtime_error("No node corresponds to variable " + std::string(Literal(v)));
 }
 
 std::vector<std::shared_ptr<Node>> Implication_graph::get_children_nodes(std::shared_ptr<Node> node_ptr){
@@ -358,13 +358,16 @@ bool Implication_graph::is_conflict(){
     return conflict->num_of_parents > 0;
 }
 
-Node Implication_graph::get_node_from_literal(Literal l){
-    for(auto node_ptr : all_nodes){
+std::shared_ptr<Node> Implication_graph::get_node_from_literal(const Literal &l) const{
+    /*
+        Return the node of literal l in this graph, or null if l has no node.
+    */
+    for(auto &node_ptr : all_nodes){
         if(node_ptr->lit == l){
-            return *node_ptr;
+            return node_ptr;
         }
     }
-    throw std::runtime_error("No such node:" + std::string(l));
+    return nullptr;
 }
 
 
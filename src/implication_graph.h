@@ -28,7 +28,7 @@ public:
     size_t find_decision_level_of_variable(const Variable &l);
     Node get_first_UIP(size_t decision_level);
     Implication_graph get_partial_implication_graph(size_t decision_level);
-    Node get_node_from_literal(Literal l);
+    std::shared_ptr<Node> get_node_from_literal(const Literal &l) const;
 
     
 private:
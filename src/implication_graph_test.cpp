@@ -5,7 +5,7 @@
 #include <vector>
 
 int main(){
-    Literal x1(Variable("x1"), true), x2(Variable("x2"), true), x3(Variable("x3"), true), x4(Variable("x4"), true);
+    Literal x1(Variable(0), true), x2(Variable(1), true), x3(Variable(2), true), x4(Variable(3), true);
 
     Disjunction_clause c1(std::vector<Literal>{!x1, x2});
     Disjunction_clause c2(std::vector<Literal>{!x2, !x3, x4});
@@ -0,0 +1,93 @@
+/*
+    Binary heap over dense integer keys that knows the position of every key, so that a key can be found, moved up
+    after its priority increased, or tested for membership in O(1) or O(log n).
+*/
+
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <cstdint>
+#include <vector>
+
+template<typename Compare>
+class Indexed_heap{
+public:
+    // comp(a, b) returns true iff a should be popped before b.
+    explicit Indexed_heap(Compare comp) : before(comp) {}
+
+    bool empty() const {return heap.size() == 0;}
+    size_t size() const {return heap.size();}
+
+    bool contains(uint32_t key) const{
+        return key < positions.size() && positions[key] >= 0;
+    }
+
+    void insert(uint32_t key){
+        if(key >= positions.size()){
+            positions.resize(key + 1, -1);
+        }
+        positions[key] = static_cast<int>(heap.size());
+        heap.push_back(key);
+        sift_up(heap.size() - 1);
+    }
+
+    // Restore the heap property after the priority of key increased.
+    void increase(uint32_t key){
+        sift_up(positions[key]);
+    }
+
+    uint32_t top() const {return heap[0];}
+
+    uint32_t pop(){
+        uint32_t key = heap[0];
+        heap[0] = heap.back();
+        positions[heap[0]] = 0;
+        positions[key] = -1;
+        heap.pop_back();
+        if(heap.size() > 1){
+            sift_down(0);
+        }
+        return key;
+    }
+
+private:
+    void sift_up(size_t i){
+        uint32_t key = heap[i];
+        while(i != 0){
+            size_t parent = (i - 1) >> 1;
+            if(!before(key, heap[parent])){
+                break;
+            }
+            heap[i] = heap[parent];
+            positions[heap[i]] = static_cast<int>(i);
+            i = parent;
+        }
+        heap[i] = key;
+        positions[key] = static_cast<int>(i);
+    }
+
+    void sift_down(size_t i){
+        uint32_t key = heap[i];
+        while(2 * i + 1 < heap.size()){
+            size_t child = 2 * i + 1;
+            if(child + 1 < heap.size() && before(heap[child + 1], heap[child])){
+                ++child;
+            }
+            if(!before(heap[child], key)){
+                break;
+            }
+            heap[i] = heap[child];
+            positions[heap[i]] = static_cast<int>(i);
+            i = child;
+        }
+        heap[i] = key;
+        positions[key] = static_cast<int>(i);
+    }
+
+    Compare before;
+    std::vector<uint32_t> heap;
+    // Position of each key in heap, or -1 if the key is not in the heap.
+    std::vector<int> positions;
+};
+
+#endif
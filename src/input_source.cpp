@@ -0,0 +1,233 @@
+#include "input_source.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifdef HAVE_BZIP2
+#include <bzlib.h>
+#endif
+
+namespace {
+
+typedef std::unique_ptr<std::FILE, int(*)(std::FILE*)> File_ptr;
+
+class Plain_source : public Input_source{
+public:
+    explicit Plain_source(File_ptr f) : file(std::move(f)) {}
+
+    size_t read(char *buffer, size_t size) override{
+        return std::fread(buffer, 1, size, file.get());
+    }
+
+private:
+    File_ptr file;
+};
+
+#ifdef HAVE_ZLIB
+class Gzip_source : public Input_source{
+public:
+    explicit Gzip_source(const std::string &file_name) : file(gzopen(file_name.c_str(), "rb")), name(file_name) {
+        if(!file){
+            throw std::invalid_argument("Cannot open file " + file_name);
+        }
+        gzbuffer(file, 1 << 17);
+    }
+
+    ~Gzip_source(){
+        gzclose(file);
+    }
+
+    size_t read(char *buffer, size_t size) override{
+        /*
+        gzread() reports a stream that ends before its gzip trailer only through gzerror(), as Z_BUF_ERROR, once it
+        has returned the data before the cut: check it when nothing more is read.
+        */
+        int n = gzread(file, buffer, static_cast<unsigned>(size));
+        if(n < 0){
+            throw std::runtime_error("Cannot decompress " + name + ": corrupted gzip data.");
+        }
+        if(n == 0){
+            int error;
+            gzerror(file, &error);
+            if(error == Z_BUF_ERROR){
+                throw std::runtime_error("Cannot decompress " + name + ": truncated gzip data.");
+            }
+            if(error != Z_OK){
+                throw std::runtime_error("Cannot decompress " + name + ": corrupted gzip data.");
+            }
+        }
+        return static_cast<size_t>(n);
+    }
+
+private:
+    gzFile file;
+    std::string name;
+};
+#endif
+
+#ifdef HAVE_LZMA
+class Xz_source : public Input_source{
+public:
+    Xz_source(File_ptr f, const std::string &file_name) : file(std::move(f)), name(file_name), input(1 << 17), finished(false) {
+        stream = LZMA_STREAM_INIT;
+        if(lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK){
+            throw std::runtime_error("Cannot initialize xz decoder for " + file_name);
+        }
+    }
+
+    ~Xz_source(){
+        lzma_end(&stream);
+    }
+
+    size_t read(char *buffer, size_t size) override{
+        if(finished){
+            return 0;
+        }
+        stream.next_out = reinterpret_cast<uint8_t*>(buffer);
+        stream.avail_out = size;
+        while(stream.avail_out != 0){
+            lzma_action action = LZMA_RUN;
+            if(stream.avail_in == 0){
+                stream.next_in = reinterpret_cast<uint8_t*>(input.data());
+                stream.avail_in = std::fread(input.data(), 1, input.size(), file.get());
+                if(stream.avail_in == 0){
+                    action = LZMA_FINISH;
+                }
+            }
+            lzma_ret ret = lzma_code(&stream, action);
+            if(ret == LZMA_STREAM_END){
+                finished = true;
+                break;
+            }
+            if(ret != LZMA_OK){
+                throw std::runtime_error("Cannot decompress " + name + ": corrupted xz data.");
+            }
+        }
+        return size - stream.avail_out;
+    }
+
+private:
+    File_ptr file;
+    std::string name;
+    std::vector<char> input;
+    lzma_stream stream;
+    bool finished;
+};
+#endif
+
+#ifdef HAVE_BZIP2
+class Bzip2_source : public Input_source{
+public:
+    Bzip2_source(File_ptr f, const std::string &file_name) : file(std::move(f)), name(file_name), input(1 << 17), finished(false) {
+        std::memset(&stream, 0, sizeof(stream));
+        if(BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK){
+            throw std::runtime_error("Cannot initialize bzip2 decoder for " + file_name);
+        }
+    }
+
+    ~Bzip2_source(){
+        BZ2_bzDecompressEnd(&stream);
+    }
+
+    size_t read(char *buffer, size_t size) override{
+        /*
+        Decompress into buffer. Concatenated bzip2 streams (as written by pbzip2) are decoded one after the other.
+        */
+        if(finished){
+            return 0;
+        }
+        stream.next_out = buffer;
+        stream.avail_out = static_cast<unsigned>(size);
+        while(stream.avail_out != 0){
+            if(stream.avail_in == 0){
+                stream.next_in = input.data();
+                stream.avail_in = static_cast<unsigned>(std::fread(input.data(), 1, input.size(), file.get()));
+                if(stream.avail_in == 0){
+                    throw std::runtime_error("Cannot decompress " + name + ": truncated bzip2 data.");
+                }
+            }
+            int ret = BZ2_bzDecompress(&stream);
+            if(ret == BZ_STREAM_END){
+                if(stream.avail_in == 0){
+                    stream.next_in = input.data();
+                    stream.avail_in = static_cast<unsigned>(std::fread(input.data(), 1, input.size(), file.get()));
+                }
+                if(stream.avail_in == 0){
+                    finished = true;
+                    break;
+                }
+                // Another stream follows: restart the decoder in place (it keeps a pointer to stream).
+                char *next_in = stream.next_in, *next_out = stream.next_out;
+                unsigned avail_in = stream.avail_in, avail_out = stream.avail_out;
+                BZ2_bzDecompressEnd(&stream);
+                std::memset(&stream, 0, sizeof(stream));
+                if(BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK){
+                    throw std::runtime_error("Cannot initialize bzip2 decoder for " + name);
+                }
+                stream.next_in = next_in;
+                stream.avail_in = avail_in;
+                stream.next_out = next_out;
+                stream.avail_out = avail_out;
+            }
+            else if(ret != BZ_OK){
+                throw std::runtime_error("Cannot decompress " + name + ": corrupted bzip2 data.");
+            }
+        }
+        return size - stream.avail_out;
+    }
+
+private:
+    File_ptr file;
+    std::string name;
+    std::vector<char> input;
+    bz_stream stream;
+    bool finished;
+};
+#endif
+
+}
+
+std::unique_ptr<Input_source> Input_source::open(const std::string &file_name){
+    /*
+    Open file_name for reading. The format is decided by the first bytes of the file, not by its extension.
+    Throw if the file is compressed with a format this build was not linked against.
+    */
+    File_ptr file(std::fopen(file_name.c_str(), "rb"), &std::fclose);
+    if(!file){
+        throw std::invalid_argument("Cannot open file " + file_name);
+    }
+
+    unsigned char magic[6] = {0};
+    size_t n = std::fread(magic, 1, sizeof(magic), file.get());
+    std::rewind(file.get());
+
+    if(n >= 2 && magic[0] == 0x1F && magic[1] == 0x8B){
+#ifdef HAVE_ZLIB
+        return std::unique_ptr<Input_source>(new Gzip_source(file_name));
+#else
+        throw std::runtime_error("Cannot read " + file_name + ": built without gzip support.");
+#endif
+    }
+    if(n >= 6 && std::memcmp(magic, "\xFD" "7zXZ\0", 6) == 0){
+#ifdef HAVE_LZMA
+        return std::unique_ptr<Input_source>(new Xz_source(std::move(file), file_name));
+#else
+        throw std::runtime_error("Cannot read " + file_name + ": built without xz support.");
+#endif
+    }
+    if(n >= 3 && magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h'){
+#ifdef HAVE_BZIP2
+        return std::unique_ptr<Input_source>(new Bzip2_source(std::move(file), file_name));
+#else
+        throw std::runtime_error("Cannot read " + file_name + ": built without bzip2 support.");
+#endif
+    }
+    return std::unique_ptr<Input_source>(new Plain_source(std::move(file)));
+}
@@ -0,0 +1,23 @@
+#ifndef INPUT_SOURCE_H
+#define INPUT_SOURCE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+class Input_source{
+    /*
+    A byte stream read in chunks. Compressed files are decompressed on the fly, so the whole decompressed text
+    is never held in memory.
+    */
+public:
+    virtual ~Input_source() {}
+
+    // Read up to size bytes into buffer. Return the number of bytes read, 0 at the end of the input.
+    virtual size_t read(char *buffer, size_t size) = 0;
+
+    // Open file_name, detecting gzip, xz and bzip2 compression by their magic bytes.
+    static std::unique_ptr<Input_source> open(const std::string &file_name);
+};
+
+#endif
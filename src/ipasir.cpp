@@ -0,0 +1,113 @@
+#include "ipasir.h"
+#include "solver.h"
+#include "version.h"
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+class Ipasir_solver{
+    // State of one IPASIR handle: the solver and the clause and assumptions being collected.
+public:
+    Solver solver;
+    Disjunction_clause clause;
+    std::vector<Literal> assumptions;
+    std::vector<int32_t> learned;
+};
+
+Ipasir_solver* get(void *solver){
+    return static_cast<Ipasir_solver*>(solver);
+}
+
+Literal to_literal(int32_t lit){
+    return Literal(Variable(std::abs(lit) - 1), lit > 0);
+}
+
+int32_t to_dimacs(const Literal &l){
+    int32_t v = static_cast<int32_t>(l.get_variable().get_index()) + 1;
+    return l.get_value() ? v : -v;
+}
+
+}
+
+const char * ipasir_signature(void){
+    static const std::string signature = "SimpleSATSolver " + VERSION.substr(0, VERSION.find(' '));
+    return signature.c_str();
+}
+
+void * ipasir_init(void){
+    return new Ipasir_solver();
+}
+
+void ipasir_release(void * solver){
+    delete get(solver);
+}
+
+void ipasir_add(void * solver, int32_t lit_or_zero){
+    Ipasir_solver *s = get(solver);
+    if(lit_or_zero == 0){
+        s->solver.add_clause(s->clause);
+        s->clause = Disjunction_clause();
+    }
+    else{
+        s->clause.add_literal(to_literal(lit_or_zero));
+    }
+}
+
+void ipasir_assume(void * solver, int32_t lit){
+    get(solver)->assumptions.push_back(to_literal(lit));
+}
+
+int ipasir_solve(void * solver){
+    Ipasir_solver *s = get(solver);
+    Solve_result r = s->solver.solve(s->assumptions);
+    s->assumptions.clear();
+    switch(r){
+        case Solve_result::Satisfiable: return 10;
+        case Solve_result::Unsatisfiable: return 20;
+        default: return 0;
+    }
+}
+
+int32_t ipasir_val(void * solver, int32_t lit){
+    Value v = get(solver)->solver.get_value(to_literal(lit));
+    if(v == Value::Unassigned){
+        return 0;
+    }
+    return v == Value::True ? lit : -lit;
+}
+
+int ipasir_failed(void * solver, int32_t lit){
+    const std::vector<Literal> &failed = get(solver)->solver.failed_assumptions();
+    return std::find(failed.begin(), failed.end(), to_literal(lit)) != failed.end() ? 1 : 0;
+}
+
+void ipasir_set_terminate(void * solver, void * data, int (*terminate)(void * data)){
+    if(terminate){
+        get(solver)->solver.set_terminate_callback([data, terminate]() -> bool {return terminate(data) != 0;});
+    }
+    else{
+        get(solver)->solver.set_terminate_callback(std::function<bool()>());
+    }
+}
+
+void ipasir_set_learn(void * solver, void * data, int max_length, void (*learn)(void * data, int32_t * clause)){
+    Ipasir_solver *s = get(solver);
+    if(!learn){
+        s->solver.set_learn_callback(std::function<void(const Disjunction_clause&)>());
+        return;
+    }
+    s->solver.set_learn_callback([s, data, max_length, learn](const Disjunction_clause &dc){
+        if(dc.size() > static_cast<size_t>(std::max(max_length, 0))){
+            return;
+        }
+        s->learned.clear();
+        for(size_t k = 0; k != dc.size(); ++k){
+            s->learned.push_back(to_dimacs(dc[k]));
+        }
+        s->learned.push_back(0);
+        learn(data, s->learned.data());
+    });
+}
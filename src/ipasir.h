@@ -0,0 +1,46 @@
+/*
+    IPASIR, the standard C interface of incremental SAT solvers. Literals are non-zero DIMACS integers.
+*/
+
+#ifndef IPASIR_H
+#define IPASIR_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Name and version of the solver.
+const char * ipasir_signature(void);
+
+// Create a solver, and release it with ipasir_release.
+void * ipasir_init(void);
+void ipasir_release(void * solver);
+
+// Add a literal to the clause being built; 0 ends the clause and adds it to the formula.
+void ipasir_add(void * solver, int32_t lit_or_zero);
+
+// Assume lit for the next call of ipasir_solve only.
+void ipasir_assume(void * solver, int32_t lit);
+
+// Solve the formula under the current assumptions: 10 for satisfiable, 20 for unsatisfiable, 0 if interrupted.
+int ipasir_solve(void * solver);
+
+// After a satisfiable result: lit if it is true in the model, -lit if it is false, 0 if its value does not matter.
+int32_t ipasir_val(void * solver, int32_t lit);
+
+// After an unsatisfiable result: 1 if the assumption lit was used to refute the assumptions, 0 otherwise.
+int ipasir_failed(void * solver, int32_t lit);
+
+// Make ipasir_solve return 0 as soon as terminate(data) returns a non-zero value. It is polled during search.
+void ipasir_set_terminate(void * solver, void * data, int (*terminate)(void * data));
+
+// Report every learned clause of at most max_length literals to learn(data, clause). The clause is zero terminated.
+void ipasir_set_learn(void * solver, void * data, int max_length, void (*learn)(void * data, int32_t * clause));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,94 @@
+#include "ipasir.h"
+#include <stdio.h>
+
+static int failures = 0;
+
+static void check(int condition, const char *message){
+    if(!condition){
+        printf("FAILED: %s\n", message);
+        ++failures;
+    }
+}
+
+static void add_clause(void *solver, const int32_t *lits){
+    while(*lits){
+        ipasir_add(solver, *lits++);
+    }
+    ipasir_add(solver, 0);
+}
+
+static int terminate_now(void *data){
+    (void)data;
+    return 1;
+}
+
+static void count_learned(void *data, int32_t *clause){
+    (void)clause;
+    ++*(int*)data;
+}
+
+int main(void){
+    void *solver = ipasir_init();
+    printf("%s\n", ipasir_signature());
+
+    // (1 v 2) & (-1 v 2) & (-2 v 3)
+    const int32_t c1[] = {1, 2, 0}, c2[] = {-1, 2, 0}, c3[] = {-2, 3, 0};
+    add_clause(solver, c1);
+    add_clause(solver, c2);
+    add_clause(solver, c3);
+    check(ipasir_solve(solver) == 10, "formula is satisfiable");
+    check(ipasir_val(solver, 2) == 2 && ipasir_val(solver, -3) == 3, "model satisfies the forced literals");
+
+    // Assumptions only hold for one call.
+    ipasir_assume(solver, -3);
+    ipasir_assume(solver, 1);
+    check(ipasir_solve(solver) == 20, "assumption -3 is refuted");
+    check(ipasir_failed(solver, -3) == 1, "-3 is a failed assumption");
+    check(ipasir_solve(solver) == 10, "assumptions are cleared after solve");
+
+    // A variable that occurs in no clause can still be assumed.
+    ipasir_assume(solver, 50);
+    check(ipasir_solve(solver) == 10, "assuming a fresh variable is satisfiable");
+    check(ipasir_val(solver, 50) == 50, "fresh assumption holds in the model");
+    ipasir_assume(solver, -50);
+    ipasir_assume(solver, 1);
+    check(ipasir_solve(solver) == 10, "assuming a fresh variable again");
+
+    // A satisfiable call interrupted before the first decision.
+    void *interrupted = ipasir_init();
+    const int32_t c4[] = {4, 5, 6, 0};
+    add_clause(interrupted, c4);
+    ipasir_set_terminate(interrupted, NULL, terminate_now);
+    check(ipasir_solve(interrupted) == 0, "terminate interrupts the search");
+    ipasir_set_terminate(interrupted, NULL, NULL);
+    check(ipasir_solve(interrupted) == 10, "solving resumes without terminate");
+    ipasir_release(interrupted);
+
+    // Pigeon hole: 3 pigeons in 2 holes needs conflicts, so clauses are learned.
+    void *pigeons = ipasir_init();
+    int learned = 0;
+    ipasir_set_learn(pigeons, &learned, 10, count_learned);
+    for(int p = 0; p != 3; ++p){
+        const int32_t c[] = {2 * p + 1, 2 * p + 2, 0};
+        add_clause(pigeons, c);
+    }
+    for(int h = 1; h <= 2; ++h){
+        for(int p = 0; p != 3; ++p){
+            for(int q = p + 1; q != 3; ++q){
+                const int32_t c[] = {-(2 * p + h), -(2 * q + h), 0};
+                add_clause(pigeons, c);
+            }
+        }
+    }
+    check(ipasir_solve(pigeons) == 20, "pigeon hole formula is unsatisfiable");
+    check(learned > 0, "learned clauses are reported");
+    ipasir_release(pigeons);
+
+    // Clauses added after a call are part of the next one.
+    const int32_t c5[] = {-3, 0};
+    add_clause(solver, c5);
+    check(ipasir_solve(solver) == 20, "added unit clause makes the formula unsatisfiable");
+    ipasir_release(solver);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -2,10 +2,10 @@
 #include <sstream>
 
 std::ostream& operator<<(std::ostream &os, const Literal &l){
-    if(!l.value){
+    if(!l.get_value()){
         os << "!";
     }
-    os << l.variable;
+    os << l.get_variable();
     return os;
 }
 
@@ -13,4 +13,4 @@ Literal::operator std::string() const{
     std::ostringstream oss;
     oss << *this;
     return oss.str();
-}
\ No newline at end of file
+}
@@ -2,35 +2,42 @@
 #define LITERAL_H
 
 #include "variable.h"
+#include <string>
 
 class Literal{
 friend class LiteralHash;
 friend std::ostream& operator<<(std::ostream &os, const Literal &l);
 public:
-    Literal(Variable var = Variable(), bool val = true) : variable(var), value(val) {}
+    // A literal is encoded as 2 * variable + sign, where sign is 1 for a negated variable.
+    Literal(Variable var = Variable(), bool val = true) : code(2 * var.get_index() + (val ? 0 : 1)) {}
 
-    bool operator==(const Literal &l) const {return variable == l.variable && value == l.value;}
+    // Build a literal back from the value returned by get_index().
+    static Literal from_index(uint32_t i) {Literal l; l.code = i; return l;}
+
+    bool operator==(const Literal &l) const {return code == l.code;}
     bool operator!=(const Literal &l) const {return !(*this == l);}
-    Literal operator!() const {return Literal(variable, !value);}
+    Literal operator!() const {return from_index(code ^ 1);}
     operator std::string() const;
 
-    Variable get_variable() const {return variable;}
+    Variable get_variable() const {return Variable(code >> 1);}
+    bool get_value() const {return !(code & 1);}
+    // Dense index of this literal, suitable for indexing per-literal arrays.
+    uint32_t get_index() const {return code;}
 
 private:
-    Variable variable;
-    bool value;
+    uint32_t code;
 
 };
 
 std::ostream& operator<<(std::ostream &os, const Literal &l);
 class LiteralHash{
-    // Compute hash based on underlying name and value.
+    // Literals are dense, so the encoding itself is a perfect hash.
 public:
     size_t operator()(const Literal &v) const{
-        return VariableHash()(v.variable) ^ (std::hash<bool>()(v.value) << 1);
+        return v.code;
     }
 };
 
 
 
-#endif
\ No newline at end of file
+#endif
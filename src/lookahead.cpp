@@ -0,0 +1,140 @@
+#include "lookahead.h"
+#include <algorithm>
+
+Lookahead::Lookahead(Solver &s) : solver(s){
+    std::vector<size_t> occurrences(s.levels.size(), 0);
+    for(auto cr : s.clauses){
+        Clause c = s.arena[cr];
+        if(c.is_deleted()){
+            continue;
+        }
+        for(size_t k = 0; k != c.size(); ++k){
+            ++occurrences[c[k].get_variable().get_index()];
+        }
+    }
+    for(size_t i = 0; i != s.binaries.size(); ++i){
+        for(auto &b : s.binaries[i]){
+            if(!b.learned){
+                ++occurrences[Literal::from_index(i).get_variable().get_index()];
+            }
+        }
+    }
+    for(size_t i = 0; i != occurrences.size(); ++i){
+        if(occurrences[i]){
+            candidates.push_back(Variable(i));
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [&occurrences](const Variable &a, const Variable &b) -> bool {return occurrences[a.get_index()] > occurrences[b.get_index()];});
+}
+
+bool Lookahead::assign(const Literal &l){
+    /*
+    Decide l on a new decision level and propagate. Return false on a conflict; the level is kept either way.
+    */
+    solver.trail_limits.push_back(solver.trail.size());
+    ++solver.decision_level;
+    solver.trace_new_assignment(l, CREF_UNDEFINED);
+    return !solver.boolean_constraint_propagation();
+}
+
+bool Lookahead::probe(const Literal &l, size_t &implied){
+    /*
+    Tentatively assign l and count the literals it implies, including itself. Return false if l fails, that is,
+    if its propagation leads to a conflict.
+    */
+    int level = solver.decision_level;
+    size_t trail_size = solver.trail.size();
+    bool ok = assign(l);
+    implied = solver.trail.size() - trail_size;
+    solver.backtrack(level);
+    return ok;
+}
+
+std::vector<std::vector<Literal>> Lookahead::generate_cubes(unsigned depth){
+    std::vector<std::vector<Literal>> cubes;
+    solver.backtrack(0);
+    if(!solver.enqueue_unit_clauses() || solver.boolean_constraint_propagation()){
+        return cubes;
+    }
+    std::vector<Literal> cube;
+    split(cube, depth, cubes);
+    solver.backtrack(0);
+    return cubes;
+}
+
+void Lookahead::split(std::vector<Literal> &cube, unsigned depth, std::vector<std::vector<Literal>> &cubes){
+    /*
+    Emit the cubes that extend cube by at most depth branching decisions.
+    Assumption: the literals of cube are assigned and propagated without conflict. The caller undoes the
+    assignments made here by backtracking.
+
+    At each node, candidate variables are probed both ways. A variable failing both ways refutes the node, and a
+    variable failing one way forces the other value, which is added to the cube. Otherwise the node branches on the
+    variable maximizing the product of the implications of its two values, which favours balanced, strongly
+    constraining splits.
+    */
+    size_t cube_size = cube.size();
+    Literal best;
+    bool found = false;
+
+    while(depth != 0){
+        found = false;
+        size_t best_score = 0;
+        size_t probed = 0;
+        bool forced = false;
+        for(auto &v : candidates){
+            if(probed == MAX_CANDIDATES){
+                break;
+            }
+            if(solver.value_of(Literal(v, true)) != Value::Unassigned){
+                continue;
+            }
+            ++probed;
+
+            size_t positive, negative;
+            bool positive_ok = probe(Literal(v, true), positive);
+            bool negative_ok = probe(Literal(v, false), negative);
+            if(!positive_ok && !negative_ok){
+                cube.resize(cube_size);
+                return;
+            }
+            if(!positive_ok || !negative_ok){
+                Literal l(v, positive_ok);
+                cube.push_back(l);
+                if(!assign(l)){
+                    cube.resize(cube_size);
+                    return;
+                }
+                forced = true;
+                break;
+            }
+            size_t score = (positive + 1) * (negative + 1);
+            if(score > best_score){
+                best_score = score;
+                best = Literal(v, positive >= negative);
+                found = true;
+            }
+        }
+        if(!forced){
+            // Either a variable to branch on was found, or every candidate is assigned.
+            break;
+        }
+    }
+
+    if(!found){
+        cubes.push_back(cube);
+        cube.resize(cube_size);
+        return;
+    }
+
+    for(auto l : {best, !best}){
+        int level = solver.decision_level;
+        cube.push_back(l);
+        if(assign(l)){
+            split(cube, depth - 1, cubes);
+        }
+        cube.pop_back();
+        solver.backtrack(level);
+    }
+    cube.resize(cube_size);
+}
@@ -0,0 +1,32 @@
+/*
+    Lookahead class. Splits a formula into cubes by probing literals with the propagation engine of a Solver.
+*/
+
+#ifndef LOOKAHEAD_H
+#define LOOKAHEAD_H
+
+#include "solver.h"
+#include <vector>
+
+class Lookahead{
+public:
+    // s is only used for propagation; its search state is changed but no clause is learned.
+    explicit Lookahead(Solver &s);
+
+    // Split the formula into cubes of about depth decisions each. Every model of the formula satisfies one of the
+    // cubes; branches refuted by propagation are left out, so an empty result means the formula is unsatisfiable.
+    std::vector<std::vector<Literal>> generate_cubes(unsigned depth);
+
+private:
+    bool assign(const Literal &l);
+    bool probe(const Literal &l, size_t &implied);
+    void split(std::vector<Literal> &cube, unsigned depth, std::vector<std::vector<Literal>> &cubes);
+
+    // Number of variables probed at each node, taken in order of decreasing number of occurrences.
+    static const size_t MAX_CANDIDATES = 64;
+
+    Solver &solver;
+    std::vector<Variable> candidates;
+};
+
+#endif
@@ -4,6 +4,14 @@
 #include <fstream>
 #include <iterator>
 #include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
 #include <boost/program_options.hpp>
 #include "signal.h"
 
@@ -11,6 +19,9 @@
 #include "benchmark_reader.h"
 #include "conjunction_clause.h"
 #include "solver.h"
+#include "portfolio.h"
+#include "cube_and_conquer.h"
+#include "preprocessor.h"
 
 
 namespace po = boost::program_options;
@@ -33,6 +44,17 @@ std::pair<po::variables_map, po::options_description> parse_argument(int argc, c
             --input-file => (positional option) specify the benchmark file to solve.
             --dump-to-file FILE => where to output the result.
             -v | --verbose => whether output intermediate processing detail.
+            --heuristic NAME => decision heuristic, evsids (default) or vmtf.
+            --polarity MODE => value of decisions: saved (default), negative, positive, random or target.
+            --seed N => seed for randomized choices.
+            --restart POLICY => restart policy: ema (default), luby, geometric or none.
+            --cache => load each benchmark from a binary cache FILE.cache, building it when missing or stale.
+            --jobs N => number of benchmarks solved in parallel (default 1). Results are still printed in input order.
+            --portfolio N => solve each benchmark with N differently configured solvers in parallel (default 1).
+            --cubes N => split each benchmark into cubes by lookahead and solve them with N worker threads.
+            --cube-depth D => branching decisions per cube in --cubes mode (default: chosen from N).
+            --no-preprocess => search the formula as read, without subsumption and variable elimination.
+            --no-inprocess => never probe failed literals or vivify clauses during the search.
     */
 
    po::options_description generic("Generic options");
@@ -40,7 +62,18 @@ std::pair<po::variables_map, po::options_description> parse_argument(int argc, c
    ("version", "print version string")
    ("help", "print help message")
    ("dump-to-file", po::value<std::string>(), "where to output the result")
-   ("verbose,v", "whether output intermediate processing detail");
+   ("verbose,v", "whether output intermediate processing detail")
+   ("heuristic", po::value<std::string>()->default_value("evsids"), "decision heuristic: evsids or vmtf")
+   ("polarity", po::value<std::string>()->default_value("saved"), "decision polarity: saved, negative, positive, random or target")
+   ("seed", po::value<unsigned>()->default_value(0), "seed for randomized choices")
+   ("restart", po::value<std::string>()->default_value("ema"), "restart policy: ema, luby, geometric or none")
+   ("cache", "load benchmarks from binary caches next to them, building the caches when missing or stale")
+   ("jobs,j", po::value<unsigned>()->default_value(1), "number of benchmarks solved in parallel")
+   ("portfolio", po::value<unsigned>()->default_value(1), "number of differently configured solvers run in parallel on each benchmark")
+   ("cubes", po::value<unsigned>()->default_value(0), "number of worker threads solving lookahead cubes of each benchmark (cube-and-conquer)")
+   ("cube-depth", po::value<unsigned>()->default_value(0), "branching decisions per cube, 0 to choose from the number of workers")
+   ("no-preprocess", "skip subsumption and bounded variable elimination before search")
+   ("no-inprocess", "skip failed literal probing and clause vivification between restarts");
 
    po::options_description hidden("Hidden options");
    hidden.add_options()
@@ -61,11 +94,199 @@ std::pair<po::variables_map, po::options_description> parse_argument(int argc, c
 }
 
 
-void dump_result(std::ostream &is, std::vector<Literal> model){
+void dump_result(std::ostream &is, const std::vector<Literal> &model, const Conjunction_clause &cnf){
     /*
-    dump the result to stream.
+    dump the result to stream. Variables are printed with the names recorded in cnf.
     */
-    is << model << std::endl;
+    for(auto &lit : model){
+        is << (lit.get_value() ? "" : "!") << cnf.get_variable_name(lit.get_variable()) << " ";
+    }
+    is << "\n";
+}
+
+class Run_settings{
+    // Settings shared by all benchmarks of a run.
+public:
+    Run_settings() : jobs(1), portfolio(1), cube_workers(0), cube_depth(0), use_cache(false), preprocess(true), verbose(false) {}
+
+    Solver_options options;
+    unsigned jobs;
+    unsigned portfolio;
+    unsigned cube_workers;
+    unsigned cube_depth;
+    bool use_cache;
+    bool preprocess;
+    bool verbose;
+    std::string output_file;
+};
+
+class Benchmark_result{
+public:
+    Benchmark_result() : done(false), failed(false) {}
+
+    // Lines for standard output, and the model line (empty unless SAT).
+    std::string report;
+    std::string model;
+    bool done;
+    bool failed;
+};
+
+std::string result_name(Solve_result r){
+    switch(r){
+        case Solve_result::Satisfiable: return "SAT";
+        case Solve_result::Unsatisfiable: return "UNSAT";
+        default: return "UNKNOWN";
+    }
+}
+
+Benchmark_result solve_benchmark(const std::string &fn, const Run_settings &settings){
+    /*
+    Read and solve one benchmark in the calling thread, and format its result. Errors are reported in the result
+    instead of being thrown, so one bad file does not stop a batch.
+    */
+    Benchmark_result result;
+    std::ostringstream report;
+    auto wall_start = std::chrono::steady_clock::now();
+    double cpu_start = thread_cpu_seconds();
+    // CPU time of the threads of a portfolio or of cube workers, which the clock of this thread does not see.
+    double helper_cpu = 0;
+    const Solver_options &options = settings.options;
+    bool verbose = settings.verbose;
+
+    try{
+        Benchmark_reader br(fn, settings.use_cache);
+        const Conjunction_clause &original = br.get_formula();
+        if(verbose){
+            report << br.get_normalization_statistics();
+        }
+
+        // Search the simplified formula, and complete its models with the variables the preprocessor removed.
+        std::unique_ptr<Preprocessor> preprocessor;
+        Conjunction_clause simplified;
+        if(settings.preprocess){
+            preprocessor.reset(new Preprocessor(original));
+            preprocessor->run();
+            simplified = preprocessor->get_formula();
+            if(verbose){
+                report << *preprocessor;
+            }
+        }
+        const Conjunction_clause &cnf = preprocessor ? simplified : original;
+        auto complete = [&preprocessor](const std::vector<Literal> &model){
+            return preprocessor ? preprocessor->extend_model(model) : model;
+        };
+
+        std::ostringstream model;
+        if(settings.cube_workers > 0){
+            Cube_and_conquer cc(cnf, settings.cube_workers, settings.cube_depth, options, verbose);
+            Solve_result r = cc.solve();
+            helper_cpu = cc.get_cpu_seconds();
+            report << "Benchmark " << fn << ": " << result_name(r) << "\n";
+            if(verbose){
+                report << "c cubes: " << cc.get_num_cubes() << "\n";
+            }
+            if(r == Solve_result::Satisfiable){
+                dump_result(model, complete(cc.get_model()), original);
+            }
+        }
+        else if(settings.portfolio > 1){
+            Portfolio p(cnf, settings.portfolio, options, verbose);
+            Solve_result r = p.solve();
+            helper_cpu = p.get_cpu_seconds();
+            report << "Benchmark " << fn << ": " << result_name(r) << "\n";
+            if(verbose && r != Solve_result::Unknown){
+                const Solver_options &o = p.get_winner_options();
+                report << "c portfolio winner: " << p.get_winner() << " (" << o.heuristic << ", " << o.restart << ", " << Solver_options::polarity_name(o.polarity) << ", seed " << o.seed << ")\n";
+                report << p.get_statistics();
+            }
+            if(r == Solve_result::Satisfiable){
+                dump_result(model, complete(p.get_model()), original);
+            }
+        }
+        else{
+            // Create solver object. It is solved once, so it may simplify the formula to an equisatisfiable one.
+            Solver_options single = options;
+            single.one_shot = true;
+            Solver s(cnf, verbose, single);
+
+            Solve_result r = s.solve();
+            report << "Benchmark " << fn << ": " << result_name(r) << "\n";
+            if(verbose){
+                report << s.get_statistics();
+            }
+            if(r == Solve_result::Satisfiable){
+                dump_result(model, complete(s.get_model()), original);
+            }
+        }
+        result.model = model.str();
+    }
+    catch(const std::exception &e){
+        report << "Benchmark " << fn << ": ERROR " << e.what() << "\n";
+        result.failed = true;
+    }
+
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wall_start;
+    report << std::fixed << std::setprecision(3) << "c time: wall " << wall.count() << " s, cpu " << thread_cpu_seconds() - cpu_start + helper_cpu << " s\n";
+    result.report = report.str();
+    return result;
+}
+
+bool solve_benchmarks(const std::vector<std::string> &files, const Run_settings &settings){
+    /*
+    Solve files with a pool of settings.jobs threads, each taking the next unsolved benchmark with its own Solver. Results are
+    written by the calling thread in input order as soon as all earlier ones are written. Return false if a
+    benchmark could not be solved.
+    */
+    std::vector<Benchmark_result> results(files.size());
+    std::mutex results_mutex;
+    std::condition_variable result_ready;
+    std::atomic<size_t> next_file(0);
+
+    auto worker = [&](){
+        size_t i;
+        while((i = next_file++) < files.size()){
+            Benchmark_result r = solve_benchmark(files[i], settings);
+            {
+                std::lock_guard<std::mutex> lock(results_mutex);
+                results[i] = std::move(r);
+                results[i].done = true;
+            }
+            result_ready.notify_one();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for(unsigned j = 0; j != std::max(1u, std::min<unsigned>(settings.jobs, files.size())); ++j){
+        pool.emplace_back(worker);
+    }
+
+    std::ofstream ofs;
+    if(settings.output_file != ""){
+        ofs.open(settings.output_file, std::ios::app);
+    }
+    std::ostream &model_stream = settings.output_file != "" ? static_cast<std::ostream&>(ofs) : std::cout;
+
+    bool all_solved = true;
+    for(size_t i = 0; i != files.size(); ++i){
+        Benchmark_result r;
+        {
+            std::unique_lock<std::mutex> lock(results_mutex);
+            result_ready.wait(lock, [&](){return results[i].done;});
+            r = std::move(results[i]);
+        }
+        std::cout << r.report;
+        if(r.model != ""){
+            model_stream << r.model;
+        }
+        std::cout.flush();
+        model_stream.flush();
+        all_solved = all_solved && !r.failed;
+    }
+
+    for(auto &t : pool){
+        t.join();
+    }
+    return all_solved;
 }
 
 void interrupt_handler(int s){
@@ -102,36 +323,37 @@ int main(int argc, char** argv){
         return 0;
     }
 
-    bool verbose = false;
+    Run_settings settings;
     if(vm.count("verbose")){
-        verbose = true;
+        settings.verbose = true;
+    }
+
+    settings.options.heuristic = vm["heuristic"].as<std::string>();
+    try{
+        settings.options.polarity = Solver_options::parse_polarity(vm["polarity"].as<std::string>());
     }
+    catch(const std::invalid_argument &e){
+        std::cerr << "ERROR " << e.what() << std::endl;
+        return 1;
+    }
+    settings.options.seed = vm["seed"].as<unsigned>();
+    settings.options.restart = vm["restart"].as<std::string>();
+    settings.options.inprocess = vm.count("no-inprocess") == 0;
+
+    settings.use_cache = vm.count("cache") > 0;
+    settings.preprocess = vm.count("no-preprocess") == 0;
+    settings.jobs = vm["jobs"].as<unsigned>();
+    settings.portfolio = vm["portfolio"].as<unsigned>();
+    settings.cube_workers = vm["cubes"].as<unsigned>();
+    settings.cube_depth = vm["cube-depth"].as<unsigned>();
 
-    std::string output_file = "";
     if(vm.count("dump-to-file")){
-        output_file = vm["dump-to-file"].as<std::string>();
+        settings.output_file = vm["dump-to-file"].as<std::string>();
     }
 
     if (vm.count("input-file")){
-        for(auto fn : vm["input-file"].as<std::vector<std::string>>()){
-            Benchmark_reader br(fn);
-            Conjunction_clause cnf = br.get_formula();
-
-            // Create solver object
-            Solver s(cnf, verbose);
-
-            bool b = s.solve();
-            std::cout << "Benchmark " << fn << ": " << (b ? "SAT" : "UNSAT") << std::endl;
-            if(b){
-                std::vector<Literal> model = s.get_model();
-                if(output_file != ""){
-                    std::ofstream ofs(output_file, std::ios::app);
-                    dump_result(ofs, model);
-                }
-                else{
-                    dump_result(std::cout, model);
-                }
-            }
+        if(!solve_benchmarks(vm["input-file"].as<std::vector<std::string>>(), settings)){
+            return 1;
         }
     }
     return 0;
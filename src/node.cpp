@@ -1,4 +1,5 @@
 #include "node.h"
+#include <algorithm>
 
 
 void Node::remove_parent(std::shared_ptr<Node> node_ptr){
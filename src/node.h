@@ -13,7 +13,7 @@
 
 class Node{
     // A node in the implication graph.
-    // If the underlying var has empty name, then this node represents the conflict node.
+    // If the underlying var is undefined, then this node represents the root (positive literal) or the conflict node (negative literal).
 friend class Implication_graph;
 friend class PtrToNodeHash;
 friend class PtrToNodeCompare;
@@ -23,7 +23,7 @@ public:
 
     bool operator==(const Node &n) const {return this->lit == n.lit && this->decision_level == n.decision_level;}
     bool operator!=(const Node &n) const {return !this->operator==(n);}
-    bool operator<(const Node &n) const {return this->decision_level < n.decision_level || this->lit.get_variable().get_name() < n.lit.get_variable().get_name();}
+    bool operator<(const Node &n) const {return this->decision_level < n.decision_level || (this->decision_level == n.decision_level && this->lit.get_index() < n.lit.get_index());}
 
     Literal get_literal() const {return lit;}
     size_t get_decision_level() const {return decision_level;}
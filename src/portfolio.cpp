@@ -0,0 +1,113 @@
+#include "portfolio.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+Portfolio::Portfolio(const Conjunction_clause &c, unsigned num_solvers, const Solver_options &base, bool v) : cnf(c), verbose(v), solvers(std::max(1u, num_solvers)), winner(0), cpu_seconds(0) {
+    for(unsigned i = 0; i != solvers.size(); ++i){
+        configurations.push_back(diversify(base, i));
+    }
+}
+
+Solver_options Portfolio::diversify(const Solver_options &base, unsigned i){
+    /*
+    Every configuration gets its own seed. Apart from the first, they cycle through combinations of heuristic,
+    restart policy and polarity mode that behave differently on structured and random instances.
+    */
+    struct Variant{
+        const char *heuristic;
+        const char *restart;
+        Polarity_mode polarity;
+    };
+    static const Variant variants[] = {
+        {"vmtf", "luby", Polarity_mode::Saved},
+        {"evsids", "ema", Polarity_mode::Target},
+        {"vmtf", "ema", Polarity_mode::Target},
+        {"evsids", "luby", Polarity_mode::Negative},
+        {"evsids", "geometric", Polarity_mode::Saved},
+        {"vmtf", "geometric", Polarity_mode::Positive},
+        {"evsids", "ema", Polarity_mode::Random},
+    };
+    const size_t num_variants = sizeof(variants) / sizeof(variants[0]);
+
+    Solver_options o = base;
+    o.seed = base.seed + i;
+    if(i != 0){
+        const Variant &v = variants[(i - 1) % num_variants];
+        o.heuristic = v.heuristic;
+        o.restart = v.restart;
+        o.polarity = v.polarity;
+    }
+    return o;
+}
+
+Solve_result Portfolio::solve(){
+    /*
+    Run one thread per configuration. Each thread builds its own Solver, so only the formula is shared. The first
+    solver to return an answer raises the shared stop flag; the others then return Unknown at their next decision.
+    While they run, the solvers share short learned clauses through a Clause_exchange.
+    An exception thrown by a solver is rethrown here if no solver found an answer.
+    */
+    std::atomic<bool> stop(false);
+    std::mutex winner_mutex;
+    bool has_winner = false;
+    Solve_result result = Solve_result::Unknown;
+    std::exception_ptr error;
+    std::vector<double> thread_cpu(solvers.size(), 0);
+    exchange.reset(new Clause_exchange(solvers.size()));
+
+    auto run = [&](size_t i){
+        double cpu_start = thread_cpu_seconds();
+        try{
+            solvers[i].reset(new Solver(cnf, verbose, configurations[i]));
+            solvers[i]->set_stop_flag(&stop);
+            solvers[i]->set_clause_exchange(exchange.get(), i);
+            Solve_result r = solvers[i]->solve();
+            if(r != Solve_result::Unknown){
+                std::lock_guard<std::mutex> lock(winner_mutex);
+                if(!has_winner){
+                    has_winner = true;
+                    winner = i;
+                    result = r;
+                    stop = true;
+                }
+            }
+        }
+        catch(...){
+            std::lock_guard<std::mutex> lock(winner_mutex);
+            if(!error){
+                error = std::current_exception();
+            }
+        }
+        thread_cpu[i] = thread_cpu_seconds() - cpu_start;
+    };
+
+    std::vector<std::thread> threads;
+    for(size_t i = 0; i != solvers.size(); ++i){
+        threads.emplace_back(run, i);
+    }
+    cpu_seconds = 0;
+    for(size_t i = 0; i != threads.size(); ++i){
+        threads[i].join();
+        cpu_seconds += thread_cpu[i];
+    }
+
+    if(!has_winner && error){
+        std::rethrow_exception(error);
+    }
+    return result;
+}
+
+std::vector<Literal> Portfolio::get_model(){
+    return solvers[winner]->get_model();
+}
+
+const Statistics& Portfolio::get_statistics() const{
+    return solvers[winner]->get_statistics();
+}
+
+const Solver_options& Portfolio::get_winner_options() const{
+    return configurations[winner];
+}
@@ -0,0 +1,44 @@
+/*
+    Portfolio class. Runs several differently configured Solvers on the same formula in parallel threads; the first
+    one to find an answer stops the others.
+*/
+
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include "conjunction_clause.h"
+#include "solver.h"
+#include "solver_options.h"
+#include "clause_exchange.h"
+#include <vector>
+#include <memory>
+
+class Portfolio{
+public:
+    // Prepare num_solvers configurations derived from base. c is only read, and must outlive solve().
+    Portfolio(const Conjunction_clause &c, unsigned num_solvers, const Solver_options &base, bool v = false);
+    Solve_result solve();
+
+    // The following are valid after solve() returned Satisfiable or Unsatisfiable.
+    std::vector<Literal> get_model();
+    const Statistics& get_statistics() const;
+    const Solver_options& get_winner_options() const;
+    size_t get_winner() const {return winner;}
+    // CPU time used by all solver threads of the last solve().
+    double get_cpu_seconds() const {return cpu_seconds;}
+
+    // Configuration of the i-th solver of a portfolio. Configuration 0 is base itself.
+    static Solver_options diversify(const Solver_options &base, unsigned i);
+
+private:
+    const Conjunction_clause &cnf;
+    bool verbose;
+    std::vector<Solver_options> configurations;
+    std::vector<std::unique_ptr<Solver>> solvers;
+    // Learned clauses are shared between the solvers through this exchange.
+    std::unique_ptr<Clause_exchange> exchange;
+    size_t winner;
+    double cpu_seconds;
+};
+
+#endif
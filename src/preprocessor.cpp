@@ -0,0 +1,479 @@
+#include "preprocessor.h"
+#include <algorithm>
+
+namespace {
+
+bool index_less(const Literal &a, const Literal &b){
+    return a.get_index() < b.get_index();
+}
+
+void erase_occurrence(std::vector<uint32_t> &list, uint32_t ci){
+    auto iter = std::find(list.begin(), list.end(), ci);
+    if(iter != list.end()){
+        *iter = list.back();
+        list.pop_back();
+    }
+}
+
+}
+
+Preprocessor::Preprocessor(const Conjunction_clause &cnf) : num_variables(cnf.get_num_variables()), occurrences(2 * cnf.get_num_variables()), values(cnf.get_num_variables(), 0), propagation_head(0), unsatisfiable(false), frozen(cnf.get_num_variables(), 0), eliminated(cnf.get_num_variables(), 0), touched(cnf.get_num_variables(), 1), occurring(cnf.get_num_variables(), 0), marks(2 * cnf.get_num_variables(), 0), stamp(0), steps(0), original_clauses(cnf.size()), num_eliminated(0), num_subsumed(0), num_strengthened(0) {
+    clauses.reserve(cnf.size());
+    for(auto &dc : cnf.get_clauses()){
+        for(auto &l : dc.get_literals()){
+            occurring[l.get_variable().get_index()] = 1;
+        }
+        add_clause(dc.get_literals());
+    }
+    for(auto &v : cnf.get_unconstrained_variables()){
+        occurring[v.get_index()] = 1;
+    }
+}
+
+void Preprocessor::freeze(const Variable &v){
+    frozen[v.get_index()] = 1;
+}
+
+bool Preprocessor::run(){
+    /*
+    Propagate the units, remove subsumed clauses and strengthen clauses until nothing changes (or the step budget
+    runs out), then eliminate variables.
+    */
+    if(unsatisfiable || !propagate() || !drain_subsumption_queue()){
+        return false;
+    }
+    return eliminate_variables();
+}
+
+int Preprocessor::value_of(const Literal &l) const{
+    int v = values[l.get_variable().get_index()];
+    return l.get_value() ? v : -v;
+}
+
+void Preprocessor::assign(const Literal &l){
+    values[l.get_variable().get_index()] = l.get_value() ? 1 : -1;
+    fixed.push_back(l);
+}
+
+bool Preprocessor::propagate(){
+    /*
+    Remove the clauses satisfied by the assigned literals and strip their negations from the others, which may
+    assign more literals. Return false on a conflict.
+    */
+    while(propagation_head != fixed.size() && !unsatisfiable){
+        Literal l = fixed[propagation_head++];
+        std::vector<Clause_index> satisfied = occurrences[l.get_index()];
+        for(auto ci : satisfied){
+            if(!removed[ci]){
+                remove_clause(ci);
+            }
+        }
+        std::vector<Clause_index> falsified = occurrences[(!l).get_index()];
+        for(auto ci : falsified){
+            if(!removed[ci]){
+                strengthen_clause(ci, !l);
+            }
+        }
+    }
+    return !unsatisfiable;
+}
+
+void Preprocessor::add_clause(std::vector<Literal> literals){
+    /*
+    Add a clause: its literals are sorted and deduplicated, assigned literals are dropped, and tautologies or
+    satisfied clauses are ignored. Empty and unit clauses are not stored but make the formula unsatisfiable or
+    assign their literal.
+    */
+    std::sort(literals.begin(), literals.end(), index_less);
+    literals.erase(std::unique(literals.begin(), literals.end()), literals.end());
+    size_t kept = 0;
+    for(size_t i = 0; i != literals.size(); ++i){
+        if(i + 1 != literals.size() && literals[i + 1] == !literals[i]){
+            return;
+        }
+        int v = value_of(literals[i]);
+        if(v > 0){
+            return;
+        }
+        if(v == 0){
+            literals[kept++] = literals[i];
+        }
+    }
+    literals.resize(kept);
+
+    if(literals.size() == 0){
+        unsatisfiable = true;
+        return;
+    }
+    if(literals.size() == 1){
+        assign(literals[0]);
+        return;
+    }
+
+    Clause_index ci = static_cast<Clause_index>(clauses.size());
+    for(auto &l : literals){
+        occurrences[l.get_index()].push_back(ci);
+        touched[l.get_variable().get_index()] = 1;
+    }
+    signatures.push_back(signature(literals));
+    clauses.push_back(std::move(literals));
+    removed.push_back(0);
+    queued.push_back(1);
+    subsumption_queue.push_back(ci);
+}
+
+void Preprocessor::remove_clause(Clause_index ci){
+    for(auto &l : clauses[ci]){
+        erase_occurrence(occurrences[l.get_index()], ci);
+        touched[l.get_variable().get_index()] = 1;
+    }
+    removed[ci] = 1;
+    std::vector<Literal>().swap(clauses[ci]);
+}
+
+void Preprocessor::strengthen_clause(Clause_index ci, const Literal &l){
+    /*
+    Remove l from clause ci. A clause left with one literal is replaced by the assignment of that literal.
+    */
+    std::vector<Literal> &c = clauses[ci];
+    c.erase(std::find(c.begin(), c.end(), l));
+    erase_occurrence(occurrences[l.get_index()], ci);
+    touched[l.get_variable().get_index()] = 1;
+
+    if(c.size() == 1){
+        Literal unit = c[0];
+        remove_clause(ci);
+        int v = value_of(unit);
+        if(v == 0){
+            assign(unit);
+        }
+        else if(v < 0){
+            unsatisfiable = true;
+        }
+        return;
+    }
+    signatures[ci] = signature(c);
+    if(!queued[ci]){
+        queued[ci] = 1;
+        subsumption_queue.push_back(ci);
+    }
+}
+
+uint64_t Preprocessor::signature(const std::vector<Literal> &literals){
+    /*
+    One bit per variable (modulo 64): if C subsumes or strengthens D, the signature of C is contained in D's.
+    */
+    uint64_t s = 0;
+    for(auto &l : literals){
+        s |= uint64_t(1) << (l.get_variable().get_index() & 63);
+    }
+    return s;
+}
+
+Preprocessor::Subsumption Preprocessor::subsumption_check(const std::vector<Literal> &c, const std::vector<Literal> &d, Literal &strengthened){
+    /*
+    Return Subsumes if every literal of c is in d, and Strengthens if this holds except for one literal x of c
+    whose negation is in d; that negation is stored in strengthened. Both clauses are sorted by literal index,
+    so one merge-like pass over d suffices.
+    */
+    steps += c.size() + d.size();
+    bool flipped = false;
+    size_t j = 0;
+    for(auto &x : c){
+        uint32_t var = x.get_variable().get_index();
+        while(j != d.size() && d[j].get_variable().get_index() < var){
+            ++j;
+        }
+        if(j == d.size() || d[j].get_variable().get_index() != var){
+            return Subsumption::None;
+        }
+        if(d[j] != x){
+            if(flipped){
+                return Subsumption::None;
+            }
+            flipped = true;
+            strengthened = d[j];
+        }
+        ++j;
+    }
+    return flipped ? Subsumption::Strengthens : Subsumption::Subsumes;
+}
+
+void Preprocessor::backward_subsume(Clause_index ci){
+    /*
+    Remove the clauses subsumed by clause ci and strengthen the clauses it self-subsumes. Candidates contain the
+    variable of ci with the fewest occurrences.
+    */
+    // Only other clauses change below, and no clause is added, so c stays valid.
+    const std::vector<Literal> &c = clauses[ci];
+    Literal best = c[0];
+    for(auto &l : c){
+        if(occurrences[l.get_index()].size() + occurrences[(!l).get_index()].size() < occurrences[best.get_index()].size() + occurrences[(!best).get_index()].size()){
+            best = l;
+        }
+    }
+
+    for(Literal l : {best, !best}){
+        std::vector<Clause_index> candidates = occurrences[l.get_index()];
+        for(auto di : candidates){
+            if(di == ci || removed[di] || clauses[di].size() < c.size() || (signatures[ci] & ~signatures[di]) != 0){
+                continue;
+            }
+            Literal strengthened;
+            Subsumption s = subsumption_check(c, clauses[di], strengthened);
+            if(s == Subsumption::Subsumes){
+                remove_clause(di);
+                ++num_subsumed;
+            }
+            else if(s == Subsumption::Strengthens){
+                strengthen_clause(di, strengthened);
+                ++num_strengthened;
+                if(unsatisfiable){
+                    return;
+                }
+            }
+        }
+    }
+}
+
+bool Preprocessor::is_forward_subsumed(const std::vector<Literal> &c){
+    /*
+    Return whether a stored clause is contained in c.
+    */
+    uint64_t s = signature(c);
+    for(auto &l : c){
+        for(auto di : occurrences[l.get_index()]){
+            Literal strengthened;
+            if(clauses[di].size() <= c.size() && (signatures[di] & ~s) == 0 && subsumption_check(clauses[di], c, strengthened) == Subsumption::Subsumes){
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool Preprocessor::drain_subsumption_queue(){
+    /*
+    Run backward subsumption from every queued clause, propagating the units it produces. Return false on a
+    conflict.
+    */
+    while(!subsumption_queue.empty() && steps < STEP_LIMIT){
+        Clause_index ci = subsumption_queue.front();
+        subsumption_queue.pop_front();
+        queued[ci] = 0;
+        if(!removed[ci]){
+            backward_subsume(ci);
+        }
+        if(!propagate()){
+            return false;
+        }
+    }
+    return !unsatisfiable;
+}
+
+bool Preprocessor::resolve(const std::vector<Literal> &c, const std::vector<Literal> &d, Variable v, std::vector<Literal> &resolvent){
+    /*
+    Store the resolvent of c and d on v, in no particular order. Return false if it is a tautology. The literals
+    of c are marked with a fresh stamp, so each literal of d is checked in constant time.
+    */
+    steps += c.size() + d.size();
+    ++stamp;
+    resolvent.clear();
+    for(auto &l : c){
+        if(l.get_variable() != v){
+            marks[l.get_index()] = stamp;
+            resolvent.push_back(l);
+        }
+    }
+    for(auto &l : d){
+        if(l.get_variable() == v || marks[l.get_index()] == stamp){
+            continue;
+        }
+        if(marks[(!l).get_index()] == stamp){
+            return false;
+        }
+        resolvent.push_back(l);
+    }
+    return true;
+}
+
+bool Preprocessor::try_eliminate(Variable v){
+    /*
+    Replace the clauses of v by their resolvents on v, unless there would be more resolvents than clauses or a
+    resolvent would be too long. The clauses of the polarity with fewer occurrences are kept on the elimination
+    stack, followed by a unit of the other polarity: extend_model(), going backwards, sets v to satisfy the larger
+    side, then flips it if a clause of the smaller side is not satisfied otherwise.
+    */
+    Literal positive(v, true), negative(v, false);
+    std::vector<Clause_index> pos = occurrences[positive.get_index()];
+    std::vector<Clause_index> neg = occurrences[negative.get_index()];
+    if(pos.size() > MAX_OCCURRENCES || neg.size() > MAX_OCCURRENCES || pos.size() + neg.size() == 0){
+        return false;
+    }
+
+    std::vector<Literal> resolvent;
+    size_t num_resolvents = 0;
+    for(auto ci : pos){
+        for(auto di : neg){
+            if(resolve(clauses[ci], clauses[di], v, resolvent)){
+                if(++num_resolvents > pos.size() + neg.size() || resolvent.size() > MAX_RESOLVENT_SIZE){
+                    return false;
+                }
+            }
+        }
+    }
+
+    // The resolvents are computed again once the elimination is decided, rather than kept from the count.
+    std::vector<std::vector<Literal>> resolvents;
+    resolvents.reserve(num_resolvents);
+    for(auto ci : pos){
+        for(auto di : neg){
+            if(resolve(clauses[ci], clauses[di], v, resolvent)){
+                std::sort(resolvent.begin(), resolvent.end(), index_less);
+                resolvents.push_back(resolvent);
+            }
+        }
+    }
+
+    bool keep_positive = pos.size() <= neg.size();
+    Literal pivot = keep_positive ? positive : negative;
+    for(auto ci : keep_positive ? pos : neg){
+        std::vector<Literal> c(1, pivot);
+        for(auto &l : clauses[ci]){
+            if(l != pivot){
+                c.push_back(l);
+            }
+        }
+        elimination_stack.push_back(std::move(c));
+    }
+    elimination_stack.push_back(std::vector<Literal>(1, !pivot));
+
+    for(auto ci : pos){
+        remove_clause(ci);
+    }
+    for(auto ci : neg){
+        remove_clause(ci);
+    }
+    eliminated[v.get_index()] = 1;
+    ++num_eliminated;
+
+    for(auto &r : resolvents){
+        if(!is_forward_subsumed(r)){
+            add_clause(std::move(r));
+        }
+        else{
+            ++num_subsumed;
+        }
+    }
+    return true;
+}
+
+bool Preprocessor::eliminate_variables(){
+    /*
+    Try to eliminate the touched variables, cheapest (fewest possible resolvents) first, and repeat on the
+    variables touched by the eliminations until none succeeds. Return false if the formula is unsatisfiable.
+    */
+    while(steps < STEP_LIMIT){
+        std::vector<Variable> candidates;
+        for(uint32_t i = 0; i != num_variables; ++i){
+            if(touched[i] && !frozen[i] && !eliminated[i] && values[i] == 0){
+                candidates.push_back(Variable(i));
+            }
+            touched[i] = 0;
+        }
+        auto cost = [this](const Variable &v){
+            return occurrences[Literal(v, true).get_index()].size() * occurrences[Literal(v, false).get_index()].size();
+        };
+        std::sort(candidates.begin(), candidates.end(), [&cost](const Variable &a, const Variable &b){return cost(a) < cost(b);});
+
+        bool progress = false;
+        for(auto &v : candidates){
+            if(steps >= STEP_LIMIT){
+                break;
+            }
+            if(values[v.get_index()] != 0 || !try_eliminate(v)){
+                continue;
+            }
+            progress = true;
+            if(!propagate() || !drain_subsumption_queue()){
+                return false;
+            }
+        }
+        if(!progress){
+            break;
+        }
+    }
+    return !unsatisfiable;
+}
+
+Conjunction_clause Preprocessor::get_formula() const{
+    Conjunction_clause cnf;
+    cnf.reserve_variables(num_variables);
+    if(unsatisfiable){
+        cnf.add_clause(Disjunction_clause());
+        return cnf;
+    }
+    for(auto &l : fixed){
+        cnf.add_clause(Disjunction_clause(std::vector<Literal>(1, l)));
+    }
+    for(size_t i = 0; i != clauses.size(); ++i){
+        if(!removed[i]){
+            cnf.add_clause(Disjunction_clause(clauses[i]));
+        }
+    }
+    return cnf;
+}
+
+std::vector<Literal> Preprocessor::extend_model(const std::vector<Literal> &model) const{
+    /*
+    Return model followed by values for the variables of the original formula it lacks. Variables that are not
+    eliminated but no longer occur can take any value; eliminated variables are set by going through the
+    elimination stack backwards, which visits each variable after all variables eliminated later.
+    */
+    std::vector<int8_t> value(num_variables, 0);
+    for(auto &l : model){
+        value[l.get_variable().get_index()] = l.get_value() ? 1 : -1;
+    }
+    std::vector<Literal> extended(model);
+    for(uint32_t i = 0; i != num_variables; ++i){
+        if(occurring[i] && !eliminated[i] && value[i] == 0){
+            value[i] = -1;
+            extended.push_back(Literal(Variable(i), false));
+        }
+    }
+
+    for(auto it = elimination_stack.rbegin(); it != elimination_stack.rend(); ++it){
+        bool satisfied = false;
+        for(auto &l : *it){
+            int v = value[l.get_variable().get_index()];
+            if((l.get_value() ? v : -v) > 0){
+                satisfied = true;
+                break;
+            }
+        }
+        if(!satisfied){
+            Literal pivot = (*it)[0];
+            value[pivot.get_variable().get_index()] = pivot.get_value() ? 1 : -1;
+        }
+    }
+
+    for(uint32_t i = 0; i != num_variables; ++i){
+        if(eliminated[i]){
+            extended.push_back(Literal(Variable(i), value[i] > 0));
+        }
+    }
+    return extended;
+}
+
+std::ostream& operator<<(std::ostream &os, const Preprocessor &p){
+    size_t remaining = p.fixed.size();
+    for(size_t i = 0; i != p.clauses.size(); ++i){
+        remaining += !p.removed[i];
+    }
+    os << "c preprocessed clauses: " << p.original_clauses << " -> " << remaining << "\n";
+    os << "c eliminated variables: " << p.num_eliminated << "\n";
+    os << "c fixed variables: " << p.fixed.size() << "\n";
+    os << "c subsumed clauses: " << p.num_subsumed << "\n";
+    os << "c strengthened clauses: " << p.num_strengthened << "\n";
+    return os;
+}
@@ -0,0 +1,111 @@
+#ifndef PREPROCESSOR_H
+#define PREPROCESSOR_H
+
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <vector>
+#include "conjunction_clause.h"
+
+class Preprocessor{
+    /*
+    SatELite-style simplification of a formula before search, on clauses kept with occurrence lists:
+        - root-level unit propagation;
+        - subsumption: a clause that contains another clause is removed (backward from every clause, and forward
+          for every resolvent);
+        - self-subsuming strengthening: if C minus x is contained in D, which has !x, then !x is removed from D;
+        - bounded variable elimination: a variable is replaced by all non-tautological resolvents of its clauses
+          when that does not increase the number of clauses.
+    The clauses removed by elimination are kept, so that extend_model() can complete a model of the simplified
+    formula into a model of the original one.
+    */
+friend std::ostream& operator<<(std::ostream &os, const Preprocessor &p);
+public:
+    explicit Preprocessor(const Conjunction_clause &cnf);
+
+    // Keep v in the simplified formula, e.g. because later clauses or assumptions will mention it.
+    void freeze(const Variable &v);
+
+    // Simplify the formula. Return false if it was found unsatisfiable.
+    bool run();
+
+    // The simplified formula, over the same variables as the original one.
+    Conjunction_clause get_formula() const;
+
+    // Complete a model of the simplified formula with values for the variables it no longer constrains.
+    std::vector<Literal> extend_model(const std::vector<Literal> &model) const;
+
+    size_t get_num_eliminated_variables() const {return num_eliminated;}
+
+private:
+    typedef uint32_t Clause_index;
+
+    // Outcome of checking whether a clause C subsumes or strengthens a clause D.
+    enum class Subsumption { None, Subsumes, Strengthens };
+
+    // Resolvents longer than this are not worth adding: they abort the elimination of the variable.
+    static const size_t MAX_RESOLVENT_SIZE = 20;
+    // Variables occurring more often than this in one polarity are never eliminated.
+    static const size_t MAX_OCCURRENCES = 1000;
+    // Literal visits allowed for subsumption and elimination; unit propagation is always completed.
+    static const uint64_t STEP_LIMIT = 200000000;
+
+    int value_of(const Literal &l) const;
+    void assign(const Literal &l);
+    bool propagate();
+
+    void add_clause(std::vector<Literal> literals);
+    void remove_clause(Clause_index ci);
+    void strengthen_clause(Clause_index ci, const Literal &l);
+    static uint64_t signature(const std::vector<Literal> &literals);
+
+    Subsumption subsumption_check(const std::vector<Literal> &c, const std::vector<Literal> &d, Literal &strengthened);
+    void backward_subsume(Clause_index ci);
+    bool is_forward_subsumed(const std::vector<Literal> &c);
+    bool drain_subsumption_queue();
+
+    bool resolve(const std::vector<Literal> &c, const std::vector<Literal> &d, Variable v, std::vector<Literal> &resolvent);
+    bool try_eliminate(Variable v);
+    bool eliminate_variables();
+
+    size_t num_variables;
+    // Clauses with their literals sorted by index, so a literal and its negation are adjacent.
+    std::vector<std::vector<Literal>> clauses;
+    std::vector<uint64_t> signatures;
+    std::vector<char> removed;
+    // Clauses containing each literal, indexed by literal.
+    std::vector<std::vector<Clause_index>> occurrences;
+
+    // Root-level value of each variable: 1 true, -1 false, 0 unassigned.
+    std::vector<int8_t> values;
+    std::vector<Literal> fixed;
+    size_t propagation_head;
+    bool unsatisfiable;
+
+    std::deque<Clause_index> subsumption_queue;
+    std::vector<char> queued;
+
+    std::vector<char> frozen;
+    std::vector<char> eliminated;
+    // Variables whose clauses changed since they were last considered for elimination.
+    std::vector<char> touched;
+    // Clauses removed by elimination, pivot literal first, in elimination order.
+    std::vector<std::vector<Literal>> elimination_stack;
+    // Variables that occur in the original formula.
+    std::vector<char> occurring;
+
+    // Per-literal stamps marking the literals of the first clause of a resolution.
+    std::vector<uint32_t> marks;
+    uint32_t stamp;
+
+    uint64_t steps;
+
+    size_t original_clauses;
+    size_t num_eliminated;
+    size_t num_subsumed;
+    size_t num_strengthened;
+};
+
+std::ostream& operator<<(std::ostream &os, const Preprocessor &p);
+
+#endif
@@ -0,0 +1,42 @@
+#include "restart_policy.h"
+#include <stdexcept>
+
+std::unique_ptr<Restart_policy> Restart_policy::create(const std::string &name){
+    if(name == "luby"){
+        return std::unique_ptr<Restart_policy>(new Luby_restart());
+    }
+    if(name == "geometric"){
+        return std::unique_ptr<Restart_policy>(new Geometric_restart());
+    }
+    if(name == "ema"){
+        return std::unique_ptr<Restart_policy>(new EMA_restart());
+    }
+    if(name == "none"){
+        return std::unique_ptr<Restart_policy>(new No_restart());
+    }
+    throw std::invalid_argument("Unknown restart policy " + name);
+}
+
+uint64_t Luby_restart::luby(uint64_t i){
+    /*
+    Return the i-th element (from 1) of the Luby sequence.
+    */
+    uint64_t k = 1;
+    while(((uint64_t(1) << k) - 1) < i){
+        ++k;
+    }
+    while(i != (uint64_t(1) << k) - 1){
+        i -= (uint64_t(1) << (k - 1)) - 1;
+        k = 1;
+        while(((uint64_t(1) << k) - 1) < i){
+            ++k;
+        }
+    }
+    return uint64_t(1) << (k - 1);
+}
+
+void Luby_restart::on_restart(){
+    ++restarts;
+    conflicts = 0;
+    limit = unit * luby(restarts + 1);
+}
@@ -0,0 +1,95 @@
+/*
+    Restart policies. The solver reports every conflict and asks the policy after each round of propagation whether
+    to restart, i.e. backtrack to decision level 0 while keeping learned clauses and heuristic state.
+*/
+
+#ifndef RESTART_POLICY_H
+#define RESTART_POLICY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class Restart_policy{
+public:
+    virtual ~Restart_policy() {}
+
+    // Called once per conflict with the LBD of the learned clause.
+    virtual void on_conflict(unsigned lbd) = 0;
+    virtual bool should_restart() const = 0;
+    virtual void on_restart() = 0;
+
+    // Create a policy by name: "luby", "geometric", "ema" or "none".
+    static std::unique_ptr<Restart_policy> create(const std::string &name);
+};
+
+class No_restart : public Restart_policy{
+public:
+    void on_conflict(unsigned) override {}
+    bool should_restart() const override {return false;}
+    void on_restart() override {}
+};
+
+class Luby_restart : public Restart_policy{
+    // Restart after unit * luby(i) conflicts, where luby is 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ...
+public:
+    explicit Luby_restart(uint64_t u = 100) : unit(u), restarts(0), conflicts(0), limit(u * luby(1)) {}
+
+    void on_conflict(unsigned) override {++conflicts;}
+    bool should_restart() const override {return conflicts >= limit;}
+    void on_restart() override;
+
+    static uint64_t luby(uint64_t i);
+
+private:
+    uint64_t unit;
+    uint64_t restarts;
+    uint64_t conflicts;
+    uint64_t limit;
+};
+
+class Geometric_restart : public Restart_policy{
+    // The number of conflicts between restarts starts at first and grows by factor after each restart.
+public:
+    explicit Geometric_restart(double first = 100, double f = 1.5) : interval(first), factor(f), conflicts(0) {}
+
+    void on_conflict(unsigned) override {++conflicts;}
+    bool should_restart() const override {return conflicts >= interval;}
+    void on_restart() override {conflicts = 0; interval *= factor;}
+
+private:
+    double interval;
+    double factor;
+    uint64_t conflicts;
+};
+
+class EMA_restart : public Restart_policy{
+    // Glucose-style: restart when the recent LBDs (fast moving average) are clearly worse than the long-term ones
+    // (slow moving average). Both averages are bias-corrected so that they are usable from the first conflict.
+public:
+    EMA_restart() : fast(0.03), slow(1e-5), margin(1.25), minimum_conflicts(50), conflicts(0) {}
+
+    void on_conflict(unsigned lbd) override {fast.update(lbd); slow.update(lbd); ++conflicts;}
+    bool should_restart() const override {return conflicts >= minimum_conflicts && fast.get() > margin * slow.get();}
+    void on_restart() override {conflicts = 0;}
+
+private:
+    class Moving_average{
+    public:
+        explicit Moving_average(double a) : alpha(a), value(0), weight(0) {}
+        void update(double x) {value += alpha * (x - value); weight += alpha * (1 - weight);}
+        double get() const {return weight > 0 ? value / weight : 0;}
+    private:
+        double alpha;
+        double value;
+        double weight;
+    };
+
+    Moving_average fast;
+    Moving_average slow;
+    double margin;
+    uint64_t minimum_conflicts;
+    uint64_t conflicts;
+};
+
+#endif
@@ -1,270 +1,1274 @@
 #include "solver.h"
 #include "disjunction_clause.h"
 #include "heuristic.h"
-#include "solver_exception.h"
 #include "debug.h"
 
 #include <algorithm>
 
-Solver::Solver(Conjunction_clause c, bool v) : clause(c), unassigned_variables(c.get_variables_in_clause()), decision_level(0), verbose(v) {}
+const uint64_t Solver::MIN_INPROCESS_PROPAGATIONS;
 
-void Solver::backtrack(int backtrack_level){
+Solver::Solver(const Conjunction_clause &c, bool v, const Solver_options &o) : options(o), heuristic(Heuristic::create(o.heuristic, c.get_variables_in_clause(), c.get_num_variables())), decision_level(0), verbose(v), has_empty_clause(false), simplified_trail_size(SIZE_MAX), conflict_clause(CREF_UNDEFINED), conflict_found(false), asserting_reason(CREF_UNDEFINED), watches(2 * c.get_num_variables()), binaries(2 * c.get_num_variables()), values(2 * c.get_num_variables(), Value::Unassigned), levels(c.get_num_variables(), 0), reasons(c.get_num_variables(), CREF_UNDEFINED), seen(c.get_num_variables(), 0), propagation_head(0), saved_phases(c.get_num_variables(), 1), target_phases(c.get_num_variables(), 1), best_phases(c.get_num_variables(), 1), target_size(0), best_size(0), target_stamps(c.get_num_variables(), 0), target_stamp(1), next_rephase(REPHASE_INTERVAL), rephase_count(0), random_generator(o.seed), restart_policy(Restart_policy::create(o.restart)), level_stamps(c.get_num_variables() + 1, 0), lbd_stamp(0), clause_activity_increment(1), next_reduce(REDUCE_INTERVAL), reduce_count(0), next_inprocess(INPROCESS_INTERVAL), inprocess_count(0), inprocess_propagations(0), probe_position(0), vivify_position(0), stop_flag(nullptr), exchange(nullptr), exchange_id(0) {
     /*
-    Backtrack to a decision level. Update assignment, unassigned_variables, and implication_graph. Reset decision_level.
+    Copy the clauses of c into the clause arena and watch them, or into the binary implication lists.
     */
-    auto erased_nodes = ig.backtrack(backtrack_level);
+    decision_variables.resize(c.get_num_variables(), 0);
+    for(auto &v : c.get_variables_in_clause()){
+        decision_variables[v.get_index()] = 1;
+    }
+    for(auto &dc : c.get_clauses()){
+        if(dc.size() == 0){
+            has_empty_clause = true;
+            continue;
+        }
+        if(dc.size() == 2){
+            add_binary_clause(dc[0], dc[1], false);
+            continue;
+        }
+        Cref cr = arena.allocate(dc, false);
+        clauses.push_back(cr);
+        if(dc.size() >= 2){
+            attach_clause(cr);
+        }
+        else{
+            unit_clauses.push_back(cr);
+        }
+    }
+}
+
+Solver::Solver(bool v, const Solver_options &o) : Solver(Conjunction_clause(), v, o) {}
+
+void Solver::reserve_variables(size_t n){
+    /*
+    Make sure variables 0 .. n-1 exist in every per-variable and per-literal array.
+    */
+    if(n <= levels.size()){
+        return;
+    }
+    watches.resize(2 * n);
+    binaries.resize(2 * n);
+    values.resize(2 * n, Value::Unassigned);
+    levels.resize(n, 0);
+    reasons.resize(n, CREF_UNDEFINED);
+    seen.resize(n, 0);
+    saved_phases.resize(n, 1);
+    target_phases.resize(n, 1);
+    best_phases.resize(n, 1);
+    target_stamps.resize(n, 0);
+    level_stamps.resize(n + 1, 0);
+    decision_variables.resize(n, 0);
+}
+
+void Solver::add_decision_variable(const Variable &v){
+    /*
+    Hand v to the heuristic, once, so that it can be decided and unassigned.
+    Assumption: v < get_num_variables().
+    */
+    if(!decision_variables[v.get_index()]){
+        decision_variables[v.get_index()] = 1;
+        heuristic->add_variable(v);
+    }
+}
+
+void Solver::add_clause(const Disjunction_clause &dc){
+    /*
+    Add a clause to the formula, between calls of solve(). The search is reset to decision level 0 first, where
+    assignments are permanent: the clause is dropped if it is satisfied there or is a tautology, and its false
+    literals and duplicates are removed. A unit is assigned right away, and an empty clause makes the formula
+    unsatisfiable for good.
+    */
+    backtrack(0);
+    if(has_empty_clause){
+        return;
+    }
+
+    std::vector<Literal> literals = dc.get_literals();
+    std::sort(literals.begin(), literals.end(), [](const Literal &a, const Literal &b) -> bool {return a.get_index() < b.get_index();});
+    size_t max_variable = 0;
+    for(auto &l : literals){
+        max_variable = std::max<size_t>(max_variable, l.get_variable().get_index() + 1);
+    }
+    reserve_variables(max_variable);
 
-    // backtrack assignment and unassigned_variables
-    for(auto n : erased_nodes){
-        auto lit = n->get_literal();
-        auto iter = std::find_if(assignment.begin(), assignment.end(), [lit](const std::pair<Literal, Disjunction_clause> &p) -> bool {return p.first == lit;});
-        if(iter != assignment.end()){
-            assignment.erase(iter);
+    Disjunction_clause simplified;
+    for(size_t k = 0; k != literals.size(); ++k){
+        Value v = value_of(literals[k]);
+        if(v == Value::True || (k != 0 && literals[k] == !literals[k - 1])){
+            return;
         }
+        if(v == Value::Unassigned && (k == 0 || literals[k] != literals[k - 1])){
+            simplified.add_literal(literals[k]);
+        }
+    }
+    if(simplified.size() == 0){
+        has_empty_clause = true;
+        return;
+    }
 
-        auto var = lit.get_variable();
-        unassigned_variables.push_back(var);
+    for(size_t k = 0; k != simplified.size(); ++k){
+        add_decision_variable(simplified[k].get_variable());
+    }
+
+    if(simplified.size() == 2){
+        add_binary_clause(simplified[0], simplified[1], false);
+        return;
+    }
+    Cref cr = arena.allocate(simplified, false);
+    clauses.push_back(cr);
+    if(simplified.size() >= 2){
+        attach_clause(cr);
+    }
+    else{
+        unit_clauses.push_back(cr);
+        record_a_propagation(simplified[0], cr);
+    }
+}
+
+Value Solver::get_value(const Literal &l) const{
+    /*
+    Return the value of l in the current assignment; variables the solver does not know are unassigned.
+    */
+    if(l.get_index() >= values.size()){
+        return Value::Unassigned;
     }
+    return values[l.get_index()];
+}
+
+void Solver::backtrack(int backtrack_level){
+    /*
+    Backtrack to a decision level. Undo the assignments on the trail above that level and reset decision_level.
+    The cost is linear in the number of literals undone.
+    */
+    if(backtrack_level >= decision_level){
+        return;
+    }
+
+    size_t new_trail_size = trail_limits[backtrack_level];
+    for(size_t i = trail.size(); i != new_trail_size; --i){
+        Literal lit = trail[i - 1];
+        Variable var = lit.get_variable();
+        saved_phases[var.get_index()] = lit.get_value();
+        values[lit.get_index()] = Value::Unassigned;
+        values[(!lit).get_index()] = Value::Unassigned;
+        reasons[var.get_index()] = CREF_UNDEFINED;
+        heuristic->unassign(var);
+    }
+    trail.resize(new_trail_size);
+    trail_limits.resize(backtrack_level);
     decision_level = backtrack_level;
+
+    // Everything left on the trail has been fully propagated before the backtracked decisions were made.
+    propagation_head = trail.size();
 }
 
-bool Solver::solve(){
+Solve_result Solver::solve(const std::vector<Literal> &assumptions){
     /*
     Check the satisfiability of the given CNF in this solver by CDCL algorithm.
-    If the CNF is satisfiable, this function returns true, and the solution is saved in assignment.
-    Otherwise, this function returns false. 
+    If the CNF is satisfiable, this function returns Satisfiable, and the solution is saved in trail.
+    If it is not, this function returns Unsatisfiable. If the stop flag is raised first, it returns Unknown.
+
+    The assumptions are decided first, one per decision level, so the answer is for the CNF conjoined with them:
+    Unsatisfiable may only mean that the assumptions cannot hold together. Learned clauses do not depend on the
+    assumptions and are kept, so solve() may be called again, with other assumptions.
     */
 
+    backtrack(0);
+    this->assumptions = assumptions;
+    failed.clear();
+    for(auto &a : assumptions){
+        // An assumption may be the first mention of its variable.
+        reserve_variables(a.get_variable().get_index() + 1);
+        add_decision_variable(a.get_variable());
+    }
+    if(!enqueue_unit_clauses()){
+        has_empty_clause = true;
+        return Solve_result::Unsatisfiable;
+    }
+
     while(true){
         while(boolean_constraint_propagation()){
+            ++stats.conflicts;
             int backtrack_level = analyze_conflict();
             if(backtrack_level < 0){
-                return false;
+                has_empty_clause = true;
+                return Solve_result::Unsatisfiable;
+            }
+            if(options.polarity == Polarity_mode::Target){
+                update_target_phases();
             }
             backtrack(backtrack_level);
+            assert_learned_clause();
+        }
+        if(restart_policy->should_restart()){
+            restart();
+        }
+        if(stats.conflicts >= next_reduce){
+            reduce_learned_clauses();
+        }
+        if(options.polarity == Polarity_mode::Target && stats.conflicts >= next_rephase){
+            rephase();
+        }
+        if(decision_level == 0){
+            if(exchange && !import_shared_clauses()){
+                has_empty_clause = true;
+                return Solve_result::Unsatisfiable;
+            }
+            simplify_at_root();
+            if(options.inprocess && stats.conflicts >= next_inprocess && propagation_head == trail.size() && !inprocess()){
+                has_empty_clause = true;
+                return Solve_result::Unsatisfiable;
+            }
+            if(propagation_head != trail.size()){
+                // Propagate imported units and pure literals before deciding.
+                continue;
+            }
+        }
+        if((stop_flag && stop_flag->load(std::memory_order_relaxed)) || (terminate_callback && terminate_callback())){
+            return Solve_result::Unknown;
+        }
+        if(decision_level < static_cast<int>(this->assumptions.size())){
+            if(!decide_assumption()){
+                analyze_failed_assumption(this->assumptions[decision_level]);
+                return Solve_result::Unsatisfiable;
+            }
+            continue;
         }
         bool dec = decide();
         if(!dec){
-            return true;
+            return Solve_result::Satisfiable;
         }
     }
 }
 
-void Solver::update_implication_graph_if_conflict(const Disjunction_clause &dc){
+void Solver::trace_new_assignment(const Literal &l, Cref reason){
+    /*
+    Update the trail and the value/level/reason arrays when new literal is assigned.
+    */
+    trail.push_back(l);
+    values[l.get_index()] = Value::True;
+    values[(!l).get_index()] = Value::False;
+    levels[l.get_variable().get_index()] = decision_level;
+    reasons[l.get_variable().get_index()] = reason;
+}
+
+Implication_graph Solver::export_implication_graph(){
     /*
-    Add conflict edges from each node for literals in dc to conflict node.
+    Build the implication graph of the current trail, for debugging. If the last propagation ended in a conflict,
+    the conflict node and its edges are included. The solver itself never consults this graph.
+    For clause (a,b,c) => a, there are edges !b => a and !c => a with label (a,b,c).
     */
-    for(auto lit : dc.get_literals()){
-        Node n(Literal(), decision_level);
-        try{
-            n = ig.get_node_from_literal(lit);
+    Implication_graph graph;
+
+    for(auto &l : trail){
+        size_t var_index = l.get_variable().get_index();
+        Node tail(l, levels[var_index]);
+        if(reasons[var_index] == CREF_UNDEFINED){
+            graph.add_decision_node(l, levels[var_index]);
+            continue;
+        }
+
+        Cref reason = reasons[var_index];
+        Disjunction_clause dc = is_binary_reason(reason) ? Disjunction_clause(std::vector<Literal>{l, binary_reason_literal(reason)}) : arena[reason].to_disjunction_clause();
+        if(levels[var_index] == 0){
+            graph.add_edge(*(graph.root), tail, dc);
+        }
+        for(auto &lit : dc.get_literals()){
+            if(lit != l){
+                graph.add_edge(Node(!lit, levels[lit.get_variable().get_index()]), tail, dc);
+            }
         }
-        catch(const std::runtime_error &e){
-            n = ig.get_node_from_literal(!lit);
+    }
+
+    if(conflict_found){
+        Disjunction_clause dc = is_binary_reason(conflict_clause) ? Disjunction_clause(std::vector<Literal>{conflict_literal, binary_reason_literal(conflict_clause)}) : arena[conflict_clause].to_disjunction_clause();
+        for(auto &lit : dc.get_literals()){
+            graph.add_conflict_edge(Node(!lit, levels[lit.get_variable().get_index()]), dc);
         }
-        ig.add_conflict_edge(n, dc);
     }
+    return graph;
 }
 
-void Solver::trace_new_assignment(const Literal &l, const Disjunction_clause &dc){
+Value Solver::value_of(const Literal &l) const{
     /*
-    Update assignment and unassigned_variables when new literal is assigned.
+    Return the value of l under the current assignment.
     */
-    assignment.push_back({l, dc});
-    for(auto iter = unassigned_variables.begin(); iter != unassigned_variables.end(); ++iter){
-        if(*iter == l.get_variable()){
-            unassigned_variables.erase(iter);
-            break;
+    return values[l.get_index()];
+}
+
+void Solver::attach_clause(Cref cr){
+    /*
+    Start watching the first two literals of a clause.
+    Assumption: the clause has at least two literals.
+    */
+    Clause c = arena[cr];
+    watches[c[0].get_index()].push_back(cr);
+    watches[c[1].get_index()].push_back(cr);
+}
+
+void Solver::add_binary_clause(const Literal &a, const Literal &b, bool learned){
+    /*
+    Add the binary clause (a | b) to the binary implication lists. It is never deleted, except when satisfied at
+    decision level 0.
+    */
+    binaries[a.get_index()].push_back(Binary_watch{b, learned});
+    binaries[b.get_index()].push_back(Binary_watch{a, learned});
+}
+
+void Solver::remove_clause(Cref cr){
+    /*
+    Delete a clause from the database. Its watchers are dropped by the next purge_watches() and its memory is
+    reclaimed by the next garbage collection.
+    Assumption: the clause is not the reason of any current assignment.
+    */
+    arena.free(cr);
+}
+
+void Solver::purge_watches(){
+    /*
+    Drop the watchers of deleted clauses.
+    */
+    for(auto &ws : watches){
+        ws.erase(std::remove_if(ws.begin(), ws.end(), [this](Cref cr) -> bool {return arena[cr].is_deleted();}), ws.end());
+    }
+}
+
+void Solver::collect_garbage(){
+    /*
+    Compact the clause arena by copying all live clauses into a fresh arena, then update every clause reference.
+    */
+    purge_watches();
+    Clause_arena to(arena.size() - arena.wasted());
+
+    for(auto &ws : watches){
+        for(auto &cr : ws){
+            cr = arena.relocate(cr, to);
         }
     }
+    for(auto &l : trail){
+        Cref &reason = reasons[l.get_variable().get_index()];
+        if(reason != CREF_UNDEFINED && !is_binary_reason(reason)){
+            reason = arena.relocate(reason, to);
+        }
+    }
+    for(auto *list : {&clauses, &learned_clauses, &unit_clauses}){
+        size_t j = 0;
+        for(size_t i = 0; i != list->size(); ++i){
+            if(!arena[(*list)[i]].is_deleted()){
+                (*list)[j++] = arena.relocate((*list)[i], to);
+            }
+        }
+        list->resize(j);
+    }
+
+    arena.swap(to);
 }
 
-void Solver::update_implication_graph_with_new_propagation(const Literal &l, const Disjunction_clause &dc){
+bool Solver::enqueue_unit_clauses(){
     /*
-    Construct new node and add new edges when new literal is assigned.
-    Specifically, for clause (a,b,c) => a, add edge !b => a and !c => a with label (a,b,c)
+    Clauses with fewer than two literals cannot be watched, so assign their literals at decision level 0 up front.
+    Return false if the formula contains an empty clause or two contradicting unit clauses, or if an earlier
+    search derived the empty clause.
     */
-    
-    for(auto lit : dc.get_literals()){
-        if(lit != l){
-            Node head = ig.get_node_from_literal(!lit);
-            Node tail = Node(l, decision_level);
-            ig.add_edge(head, tail, dc);
+    if(has_empty_clause){
+        return false;
+    }
+    for(auto cr : unit_clauses){
+        Clause c = arena[cr];
+        Value v = value_of(c[0]);
+        if(v == Value::False){
+            return false;
         }
-        if(decision_level == 0){
-            ig.add_edge(*(ig.root), Node(l, decision_level), dc);
+        if(v == Value::Unassigned){
+            record_a_propagation(c[0], cr);
+        }
+    }
+    return true;
+}
+
+void Solver::simplify_at_root(){
+    /*
+    Delete the clauses satisfied by the root assignment and remove the false literals of the others, so that the
+    clause database shrinks as units are found instead of being rescanned. Runs at decision level 0, at the start of
+    the search and after restarts, when the root assignment grew since the last call.
+    After a complete propagation without conflict, a clause that is not satisfied has unassigned literals at its
+    watched positions 0 and 1; removing false literals keeps the order of the others, so the watches stay valid.
+    A binary clause with an assigned literal is satisfied, and a longer clause shrunk to two literals moves to the
+    binary implication lists.
+    */
+    if(propagation_head != trail.size() || trail.size() == simplified_trail_size){
+        return;
+    }
+
+    // Root assignments are permanent and never analyzed, so their reason clauses can go.
+    for(auto &l : trail){
+        reasons[l.get_variable().get_index()] = CREF_UNDEFINED;
+    }
+
+    for(size_t i = 0; i != binaries.size(); ++i){
+        Literal l = Literal::from_index(i);
+        std::vector<Binary_watch> &bs = binaries[i];
+        if(value_of(l) != Value::Unassigned){
+            // Count each clause once, from the list of its assigned literal with the lowest index.
+            for(auto &b : bs){
+                if(value_of(b.other) == Value::Unassigned || i < b.other.get_index()){
+                    ++stats.root_satisfied_clauses;
+                }
+            }
+            std::vector<Binary_watch>().swap(bs);
+        }
+        else{
+            bs.erase(std::remove_if(bs.begin(), bs.end(), [this](const Binary_watch &b) -> bool {return value_of(b.other) != Value::Unassigned;}), bs.end());
+        }
+    }
+
+    size_t removed = 0;
+    for(auto *list : {&clauses, &learned_clauses}){
+        for(auto cr : *list){
+            Clause c = arena[cr];
+            if(c.is_deleted() || c.size() < 2){
+                continue;
+            }
+            size_t j = 0;
+            bool satisfied = false;
+            for(size_t k = 0; k != c.size(); ++k){
+                Value v = value_of(c[k]);
+                if(v == Value::True){
+                    satisfied = true;
+                    break;
+                }
+                if(v == Value::Unassigned){
+                    c.set_literal(j++, c[k]);
+                }
+            }
+            if(satisfied){
+                remove_clause(cr);
+                ++stats.root_satisfied_clauses;
+                ++removed;
+            }
+            else if(j == 2){
+                stats.root_false_literals += c.size() - j;
+                add_binary_clause(c[0], c[1], c.is_learned());
+                remove_clause(cr);
+                ++removed;
+            }
+            else if(j != c.size()){
+                stats.root_false_literals += c.size() - j;
+                arena.shrink(cr, j);
+            }
+        }
+        list->erase(std::remove_if(list->begin(), list->end(), [this](Cref cr) -> bool {return arena[cr].is_deleted();}), list->end());
+    }
+
+    // Clauses satisfied by the pure literals fixed here are deleted by the next call.
+    simplified_trail_size = trail.size();
+    if(options.one_shot && assumptions.empty() && !exchange){
+        fix_pure_literals();
+    }
+
+    if(removed != 0){
+        purge_watches();
+    }
+    if(arena.wasted() > arena.size() / 5){
+        collect_garbage();
+    }
+}
+
+void Solver::fix_pure_literals(){
+    /*
+    Assign at the root every literal whose negation occurs in no original clause. This keeps the formula
+    satisfiable if it was (any model can be changed to set a pure literal), but not equivalent, so it is only done
+    when the options promise a single solve() without assumptions, and when learned clauses are not shared with
+    other solvers.
+    Clauses satisfied by a pure literal no longer count, which can make more literals pure: occurrence lists (one
+    flat array, indexed by literal through offsets) let this run to a fixpoint in one pass.
+    Assumption: called from simplify_at_root(), so no clause in clauses or binaries is satisfied.
+    */
+    // The original clauses, binary ones included, flattened: clause i is literals[starts[i] .. starts[i + 1]).
+    std::vector<Literal> literals;
+    std::vector<size_t> starts(1, 0);
+    for(auto cr : clauses){
+        Clause c = arena[cr];
+        for(size_t k = 0; k != c.size(); ++k){
+            literals.push_back(c[k]);
+        }
+        starts.push_back(literals.size());
+    }
+    for(size_t i = 0; i != binaries.size(); ++i){
+        for(auto &b : binaries[i]){
+            if(!b.learned && i <= b.other.get_index()){
+                literals.push_back(Literal::from_index(i));
+                literals.push_back(b.other);
+                starts.push_back(literals.size());
+            }
+        }
+    }
+    size_t num_clauses = starts.size() - 1;
+
+    std::vector<uint32_t> counts(values.size(), 0);
+    for(auto &l : literals){
+        ++counts[l.get_index()];
+    }
+    std::vector<size_t> offsets(values.size() + 1, 0);
+    for(size_t l = 0; l != values.size(); ++l){
+        offsets[l + 1] = offsets[l] + counts[l];
+    }
+    std::vector<uint32_t> occurrences(offsets.back());
+    std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+    for(size_t i = 0; i != num_clauses; ++i){
+        for(size_t k = starts[i]; k != starts[i + 1]; ++k){
+            occurrences[fill[literals[k].get_index()]++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    auto is_pure = [this, &counts](const Literal &l) -> bool {
+        return counts[l.get_index()] != 0 && counts[(!l).get_index()] == 0 && value_of(l) == Value::Unassigned;
+    };
+    size_t first_pure = trail.size();
+    for(size_t i = 0; i != levels.size(); ++i){
+        Literal positive(Variable(i), true);
+        if(decision_variables[i] && (is_pure(positive) || is_pure(!positive))){
+            trace_new_assignment(is_pure(positive) ? positive : !positive, CREF_UNDEFINED);
+        }
+    }
+
+    std::vector<char> satisfied(num_clauses, 0);
+    for(size_t head = first_pure; head != trail.size(); ++head){
+        Literal l = trail[head];
+        for(size_t o = offsets[l.get_index()]; o != offsets[l.get_index() + 1]; ++o){
+            uint32_t i = occurrences[o];
+            if(satisfied[i]){
+                continue;
+            }
+            satisfied[i] = 1;
+            for(size_t k = starts[i]; k != starts[i + 1]; ++k){
+                Literal q = literals[k];
+                if(--counts[q.get_index()] == 0 && is_pure(!q)){
+                    trace_new_assignment(!q, CREF_UNDEFINED);
+                }
+            }
+        }
+    }
+    stats.pure_literals += trail.size() - first_pure;
+}
+
+bool Solver::inprocess(){
+    /*
+    Run a round of inprocessing at decision level 0, after a complete propagation: failed literal probing, then
+    vivification of the learned clauses worth keeping and of original clauses. Both only derive clauses implied by
+    the formula, so they are sound with later clauses, assumptions and clause sharing. The round stops when it has
+    spent its share of propagations; the next one resumes where it stopped.
+    Return false if the formula was found unsatisfiable.
+    Assumption: decision_level == 0 and propagation_head == trail.size().
+    */
+    uint64_t budget = std::max<uint64_t>(MIN_INPROCESS_PROPAGATIONS, INPROCESS_EFFORT * (stats.propagations - inprocess_propagations));
+    uint64_t probe_limit = stats.propagations + budget / 3;
+    uint64_t vivify_limit = stats.propagations + budget;
+
+    // Probes go through backtrack(), which would overwrite the phases of the search.
+    std::vector<char> phases = saved_phases;
+    probe_marks.resize(values.size(), 0);
+    bool consistent = probe_variables(probe_limit) && vivify_clauses(vivify_limit);
+    saved_phases.swap(phases);
+    conflict_found = false;
+    // Vivified clauses that became units or binaries are detached already.
+    for(auto *list : {&clauses, &learned_clauses}){
+        list->erase(std::remove_if(list->begin(), list->end(), [this](Cref cr) -> bool {return arena[cr].is_deleted();}), list->end());
+    }
+
+    ++stats.inprocessing_rounds;
+    ++inprocess_count;
+    next_inprocess = stats.conflicts + INPROCESS_INTERVAL * (inprocess_count + 1);
+    inprocess_propagations = stats.propagations;
+    return consistent;
+}
+
+bool Solver::probe(const Literal &l, std::vector<Literal> &implied){
+    /*
+    Assign l on a new decision level and propagate. Return false if that leads to a conflict; otherwise fill
+    implied with l and the literals it implies. The solver is back at decision level 0 on return either way.
+    */
+    trail_limits.push_back(trail.size());
+    ++decision_level;
+    trace_new_assignment(l, CREF_UNDEFINED);
+    bool conflict = boolean_constraint_propagation();
+    if(!conflict){
+        implied.assign(trail.begin() + trail_limits.back(), trail.end());
+    }
+    backtrack(0);
+    return !conflict;
+}
+
+bool Solver::assign_at_root(const Literal &l){
+    /*
+    Assign l at decision level 0, where it holds for good, and propagate it. Return false on a conflict.
+    */
+    Value v = value_of(l);
+    if(v != Value::Unassigned){
+        return v == Value::True;
+    }
+    record_a_propagation(l, CREF_UNDEFINED);
+    return !boolean_constraint_propagation();
+}
+
+bool Solver::probe_variables(uint64_t propagation_limit){
+    /*
+    Failed literal probing. Both values of a variable x are propagated in turn:
+      - if x leads to a conflict, !x holds, and the other way around;
+      - a literal implied by both x and !x holds;
+      - if x implies !y and !x implies y, then y is equivalent to !x: the binary clauses (!x | !y) and (x | y) are
+        added as learned clauses, so that propagation sees the equivalence in both directions from then on.
+    Variables are visited round-robin from probe_position until the propagation limit is reached.
+    Return false if the formula was found unsatisfiable.
+    */
+    std::vector<Literal> positive_implied, negative_implied, forced;
+    size_t num_variables = levels.size();
+    for(size_t count = 0; count != num_variables && stats.propagations < propagation_limit; ++count){
+        size_t i = probe_position++ % num_variables;
+        Literal x(Variable(i), true);
+        if(!decision_variables[i] || value_of(x) != Value::Unassigned){
+            continue;
+        }
+
+        if(!probe(x, positive_implied)){
+            ++stats.failed_literals;
+            if(!assign_at_root(!x)){
+                return false;
+            }
+            continue;
+        }
+        if(!probe(!x, negative_implied)){
+            ++stats.failed_literals;
+            if(!assign_at_root(x)){
+                return false;
+            }
+            continue;
+        }
+
+        for(size_t k = 1; k < positive_implied.size(); ++k){
+            probe_marks[positive_implied[k].get_index()] = 1;
+        }
+        forced.clear();
+        for(size_t k = 1; k < negative_implied.size(); ++k){
+            Literal y = negative_implied[k];
+            if(probe_marks[y.get_index()]){
+                forced.push_back(y);
+            }
+            else if(probe_marks[(!y).get_index()]){
+                // The same pair is found again when probing the variable of y, as (y, x) or (!y, !x).
+                Literal a = x, b = y;
+                if(b.get_variable().get_index() < a.get_variable().get_index()){
+                    std::swap(a, b);
+                }
+                if(!a.get_value()){
+                    a = !a;
+                    b = !b;
+                }
+                uint64_t key = static_cast<uint64_t>(a.get_index()) << 32 | b.get_index();
+                if(equivalences.insert(key).second){
+                    ++stats.equivalent_literals;
+                    add_binary_clause(!x, !y, true);
+                    add_binary_clause(x, y, true);
+                }
+            }
+        }
+        for(size_t k = 1; k < positive_implied.size(); ++k){
+            probe_marks[positive_implied[k].get_index()] = 0;
+        }
+
+        for(auto &y : forced){
+            if(!assign_at_root(y)){
+                return false;
+            }
         }
     }
+    return true;
 }
 
-std::vector<Disjunction_clause> Solver::get_all_clauses(){
+bool Solver::vivify_clause(Cref cr){
     /*
-    Return the sum of original clauses and the learned clauses.
-    Make sure the learned clauses are consider first.
+    Vivification: assign the negations of the literals of a clause one by one, propagating after each, with the
+    clause itself detached. If a literal becomes true, the literals assigned so far and that one are already a
+    clause implied by the formula; if one becomes false, it can be dropped; if propagation conflicts, the literals
+    assigned so far are enough. The clause is rewritten in place with the literals it still needs, or moves to the
+    binary implication lists.
+    Return false if the formula was found unsatisfiable.
+    Assumption: decision level 0 after a complete propagation, and the clause has at least three literals.
     */
+    Clause c = arena[cr];
+    for(size_t k = 0; k != c.size(); ++k){
+        if(value_of(c[k]) != Value::Unassigned){
+            // Left to simplify_at_root().
+            return true;
+        }
+    }
+    for(size_t k = 0; k != 2; ++k){
+        std::vector<Cref> &ws = watches[c[k].get_index()];
+        ws.erase(std::find(ws.begin(), ws.end(), cr));
+    }
+
+    std::vector<Literal> kept;
+    for(size_t k = 0; k != c.size(); ++k){
+        Literal l = c[k];
+        Value v = value_of(l);
+        if(v == Value::False){
+            continue;
+        }
+        kept.push_back(l);
+        if(v == Value::True || k + 1 == c.size()){
+            break;
+        }
+        trail_limits.push_back(trail.size());
+        ++decision_level;
+        trace_new_assignment(!l, CREF_UNDEFINED);
+        if(boolean_constraint_propagation()){
+            break;
+        }
+    }
+    backtrack(0);
+
+    if(kept.size() != c.size()){
+        ++stats.vivified_clauses;
+        stats.vivified_literals += c.size() - kept.size();
+        for(size_t k = 0; k != kept.size(); ++k){
+            c.set_literal(k, kept[k]);
+        }
+        arena.shrink(cr, kept.size());
+        if(c.is_learned() && c.get_lbd() > kept.size()){
+            c.set_lbd(kept.size());
+        }
+    }
+    if(kept.size() == 1){
+        remove_clause(cr);
+        return assign_at_root(kept[0]);
+    }
+    if(kept.size() == 2){
+        add_binary_clause(kept[0], kept[1], c.is_learned());
+        remove_clause(cr);
+        return true;
+    }
+    attach_clause(cr);
+    return true;
+}
+
+bool Solver::vivify_clauses(uint64_t propagation_limit){
+    /*
+    Vivify learned clauses of LBD up to TIER2_LBD, most active first, then original clauses round-robin from
+    vivify_position, until the propagation limit is reached. Clauses shorter than three literals are left to
+    probing. Return false if the formula was found unsatisfiable.
+    */
+    std::vector<Cref> candidates;
+    for(auto cr : learned_clauses){
+        Clause c = arena[cr];
+        if(!c.is_deleted() && c.size() > 2 && c.get_lbd() <= TIER2_LBD){
+            candidates.push_back(cr);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](Cref a, Cref b) -> bool {return arena[a].get_activity() > arena[b].get_activity();});
+    for(size_t i = 0; i != candidates.size() && stats.propagations < propagation_limit; ++i){
+        if(!vivify_clause(candidates[i])){
+            return false;
+        }
+    }
 
-    std::vector<Disjunction_clause> all_clauses = clause.get_clauses();
-    all_clauses.insert(all_clauses.end(), learned_clauses.begin(), learned_clauses.end());
-    std::reverse(all_clauses.begin(), all_clauses.end());
-    return all_clauses;
+    for(size_t count = 0; count != clauses.size() && stats.propagations < propagation_limit; ++count){
+        Cref cr = clauses[vivify_position++ % clauses.size()];
+        Clause c = arena[cr];
+        if(!c.is_deleted() && c.size() > 2 && !vivify_clause(cr)){
+            return false;
+        }
+    }
+    return true;
 }
 
-void Solver::record_a_propagation(const Literal &propagated_literal, const Disjunction_clause &by_clause){
+void Solver::assert_learned_clause(){
     /*
-    update the underlying assignment, unassigned_variables, and implication_graph if new literal is propagated.
+    After backtracking, the latest learned clause is unit on its first literal. Propagate that literal.
     */
+    record_a_propagation(asserting_literal, asserting_reason);
+}
+
+void Solver::record_a_propagation(const Literal &propagated_literal, Cref by_clause){
+    /*
+    update the underlying assignment if new literal is propagated.
+    */
+    ++stats.propagations;
     trace_new_assignment(propagated_literal, by_clause);
-    update_implication_graph_with_new_propagation(propagated_literal, by_clause);
 }
 
 bool Solver::boolean_constraint_propagation(){
     /*
-    Propagate literals from each DNF in the given CNF based on current assignment. If the propagation leads to a conflict,
-    return true. Otherwise return false.
+    Propagate the literals assigned since the last call using the two-watched-literal scheme. Only clauses watching a
+    newly falsified literal are visited. If the propagation leads to a conflict, return true. Otherwise return false.
+    The binary clauses of a falsified literal are visited first: they imply the other literal directly, without
+    touching the arena.
+
+    Invariant: for each watched clause, the watched literals are at positions 0 and 1.
     */
-    bool new_literal_propagated;
-    do{
-        new_literal_propagated = false;
-
-        std::vector<Disjunction_clause> all_clauses = get_all_clauses();
-        for(auto clause : all_clauses){
-            Literal propagated_literal;
-            try{
-                propagated_literal = Disjunction_clause::propagate_clause(clause, assignment);
-            }
-            catch(const ConflictClauseException &e){
-                // conflict found on clause.
-                update_implication_graph_if_conflict(clause);
-                this->current_conflict_clause = clause;
+    conflict_found = false;
+    while(propagation_head < trail.size()){
+        Literal false_literal = !trail[propagation_head++];
+
+        for(auto &b : binaries[false_literal.get_index()]){
+            Value v = value_of(b.other);
+            if(v == Value::True){
+                continue;
+            }
+            if(v == Value::False){
+                conflict_clause = binary_reason(b.other);
+                conflict_literal = false_literal;
+                conflict_found = true;
                 return true;
             }
-            catch(const PropagationException &e){
+            record_a_propagation(b.other, binary_reason(false_literal));
+        }
+
+        std::vector<Cref> &ws = watches[false_literal.get_index()];
+
+        size_t i = 0, j = 0;
+        while(i != ws.size()){
+            Cref cr = ws[i++];
+            Clause c = arena[cr];
+
+            // Make sure the falsified watch is at position 1.
+            if(c[0] == false_literal){
+                c.swap_literals(0, 1);
+            }
+
+            // The clause is already satisfied by the other watch.
+            if(value_of(c[0]) == Value::True){
+                ws[j++] = cr;
+                continue;
+            }
+
+            // Look for a non-false literal to watch instead.
+            bool new_watch_found = false;
+            for(size_t k = 2; k != c.size(); ++k){
+                if(value_of(c[k]) != Value::False){
+                    c.swap_literals(1, k);
+                    watches[c[1].get_index()].push_back(cr);
+                    new_watch_found = true;
+                    break;
+                }
+            }
+            if(new_watch_found){
                 continue;
             }
 
-            new_literal_propagated = true;
-            record_a_propagation(propagated_literal, clause); 
+            // The clause is unit or conflicting under the current assignment.
+            ws[j++] = cr;
+            if(value_of(c[0]) == Value::False){
+                while(i != ws.size()){
+                    ws[j++] = ws[i++];
+                }
+                ws.resize(j);
+
+                this->conflict_clause = cr;
+                conflict_found = true;
+                return true;
+            }
+            record_a_propagation(c[0], cr);
         }
-    }while(new_literal_propagated);
+        ws.resize(j);
+    }
 
     return false;
 }
 
-Node Solver::get_first_UIP(size_t decision_level){
+Cref Solver::add_learned_clause(Disjunction_clause dc, unsigned lbd){
     /*
-    Return the node for first UIP for current implication graph.
+    Store learned clause and watch it. The first literal is the asserting one; the literal with the highest remaining
+    decision level is moved to position 1, so that after backtracking the clause is unit on its first literal.
+    Return the reason to give the first literal when it is asserted.
     */
-    return ig.get_first_UIP(decision_level);
+    size_t max_index = 1;
+    for(size_t k = 2; k < dc.size(); ++k){
+        if(levels[dc[k].get_variable().get_index()] > levels[dc[max_index].get_variable().get_index()]){
+            max_index = k;
+        }
+    }
+    if(dc.size() >= 2){
+        std::swap(dc[1], dc[max_index]);
+    }
+    if(dc.size() == 2){
+        add_binary_clause(dc[0], dc[1], true);
+        return binary_reason(dc[1]);
+    }
+
+    Cref cr = arena.allocate(dc, true, lbd);
+    bump_clause_activity(arena[cr]);
+    learned_clauses.push_back(cr);
+    if(dc.size() >= 2){
+        attach_clause(cr);
+    }
+    return cr;
 }
 
-bool Solver::stop_criterion_met(Disjunction_clause &cl, const Node &uip){
+int Solver::analyze_conflict(){
     /*
-    Return true iff cl contains the negation of the first UIP as its single literal at the current decision level.
-    Assumption: All literals in cl have been assigned.
+    Learn the first-UIP clause of the current conflict and return the decision level that we should backtrack to.
+    Return -1 if the conflict happens at decision level 0.
+    Assumption: current assignment leads to a conflict.
+
+    The trail is walked backwards from the conflict. Each literal of the current level that appears in the clauses
+    being resolved is counted once (using seen); literals of lower levels go straight into the learned clause. The
+    walk stops when only one literal of the current level is left: the first UIP. This is linear in the number of
+    literals touched.
     */
 
-    size_t decision_level_of_UIP = uip.get_decision_level();
+    if(decision_level == 0){
+        return -1;
+    }
+
+    analyzed_variables.clear();
+
+    // Position 0 is reserved for the negation of the UIP.
+    Disjunction_clause learned;
+    learned.add_literal(Literal());
+
+    int paths_to_uip = 0;
+    Literal p;
+    bool p_assigned = false;
+    Cref cr = conflict_clause;
+    size_t index = trail.size();
 
-    // Count how many literals in cl has the same decision level as n.
-    size_t count = 0;
-    auto literals_in_clause = cl.get_literals();
-    for(auto l : literals_in_clause){
-        if(ig.get_decision_level_of_literal(l) == decision_level_of_UIP){
-            ++count;
+    auto analyze_literal = [&](const Literal &q){
+        size_t var_index = q.get_variable().get_index();
+        if(seen[var_index] || levels[var_index] == 0){
+            return;
+        }
+        seen[var_index] = 1;
+        analyzed_variables.push_back(q.get_variable());
+        if(levels[var_index] >= decision_level){
+            ++paths_to_uip;
+        }
+        else{
+            learned.add_literal(q);
+        }
+    };
+
+    do{
+        if(is_binary_reason(cr)){
+            // A binary reason is the other literal of the clause; a binary conflict also has conflict_literal.
+            if(!p_assigned){
+                analyze_literal(conflict_literal);
+            }
+            analyze_literal(binary_reason_literal(cr));
         }
+        else{
+            Clause c = arena[cr];
+            if(c.is_learned()){
+                update_learned_clause_usage(c);
+            }
+            // The first literal of a reason clause is the literal it implied, which is p.
+            for(size_t k = p_assigned ? 1 : 0; k != c.size(); ++k){
+                analyze_literal(c[k]);
+            }
+        }
+
+        // Select the next literal of the current level to resolve on.
+        while(!seen[trail[--index].get_variable().get_index()]);
+        p = trail[index];
+        p_assigned = true;
+        cr = reasons[p.get_variable().get_index()];
+        seen[p.get_variable().get_index()] = 0;
+        --paths_to_uip;
+    }while(paths_to_uip > 0);
+
+    learned[0] = !p;
+
+    size_t size_before_minimization = learned.size();
+    minimize_learned_clause(learned);
+    stats.minimized_literals += size_before_minimization - learned.size();
+    stats.learned_literals += learned.size();
+
+    int backtrack_level = 0;
+    for(size_t k = 1; k != learned.size(); ++k){
+        backtrack_level = std::max(backtrack_level, levels[learned[k].get_variable().get_index()]);
     }
-    if(count != 1){
-        return false;
+
+    heuristic->bump_variables(analyzed_variables);
+    unsigned lbd = compute_lbd(learned);
+    restart_policy->on_conflict(lbd);
+    export_learned_clause(learned, lbd);
+    if(learn_callback){
+        learn_callback(learned);
     }
+    asserting_literal = learned[0];
+    asserting_reason = add_learned_clause(learned, lbd);
+    clause_activity_increment /= CLAUSE_ACTIVITY_DECAY;
+    return backtrack_level;
+}
 
-    // check if the the negation of the literal of uip is in cl.
-    auto iter = std::find(literals_in_clause.begin(), literals_in_clause.end(), !(uip.get_literal()));
-    if(iter != literals_in_clause.end()){
-        return true;
+void Solver::bump_clause_activity(Clause c){
+    /*
+    Add the current increment to the activity of a learned clause. Rescale every activity when they get too large.
+    */
+    c.set_activity(c.get_activity() + clause_activity_increment);
+    if(c.get_activity() > 1e20){
+        for(auto cr : learned_clauses){
+            Clause lc = arena[cr];
+            lc.set_activity(lc.get_activity() * 1e-20);
+        }
+        clause_activity_increment *= 1e-20;
     }
-    return false;
 }
 
-Literal Solver::get_last_assigned_literal(Disjunction_clause dc){
+void Solver::update_learned_clause_usage(Clause c){
     /*
-    Return the literal that is the latest assigned in dc.
+    A learned clause took part in conflict analysis: bump its activity, mark it used, and lower its LBD if the
+    current assignment shows a smaller one.
     */
-    auto literals = dc.get_literals();
-    for(auto iter = assignment.rbegin(); iter != assignment.rend(); ++iter){
-        // if iter->first in dc.literals
-        auto it = std::find_if(literals.begin(), literals.end(), [iter](Literal l) -> bool {return iter->first.get_variable() == l.get_variable();});
-        if(it != literals.end()){
-            return *it;
+    bump_clause_activity(c);
+    c.set_used(true);
+    if(c.get_lbd() > CORE_LBD){
+        ++lbd_stamp;
+        unsigned lbd = 0;
+        for(size_t k = 0; k != c.size(); ++k){
+            int level = levels[c[k].get_variable().get_index()];
+            if(level_stamps[level] != lbd_stamp){
+                level_stamps[level] = lbd_stamp;
+                ++lbd;
+            }
+        }
+        if(lbd < c.get_lbd()){
+            c.set_lbd(lbd);
         }
     }
-    throw std::runtime_error("None of literals in this clause is assigned.");
 }
 
-Disjunction_clause Solver::get_antecedent_clause(Literal l){
+bool Solver::is_locked(Cref cr){
     /*
-    Return the clause that implies the assignmend of l. For decision node, we return an empty clause.
+    Return true iff the clause is the reason of a current assignment, and so cannot be deleted.
     */
-   auto iter = std::find_if(assignment.begin(), assignment.end(), [l](std::pair<Literal, Disjunction_clause> p)-> bool {return p.first == l;});
-   if(iter != assignment.end()){
-       return iter->second;
-   }
-   throw std::runtime_error("Literals is not assigned.");
+    Literal first = arena[cr][0];
+    return value_of(first) == Value::True && reasons[first.get_variable().get_index()] == cr;
 }
 
-void Solver::add_learned_clause(Disjunction_clause dc){
+void Solver::reduce_learned_clauses(){
     /*
-    Store learned clause.
+    Periodically shrink the learned clause database. Learned clauses are split into tiers by LBD:
+      - core (LBD <= CORE_LBD) are kept forever,
+      - tier2 (LBD <= TIER2_LBD) are kept as long as they were used since the last reduction,
+      - local clauses, and tier2 clauses that were not used, are candidates.
+    The half of the candidates with the lowest activity is deleted. Reasons of current assignments are kept.
     */
-    learned_clauses.push_back(dc);
+    std::vector<Cref> candidates;
+    for(auto cr : learned_clauses){
+        Clause c = arena[cr];
+        if(c.get_lbd() <= CORE_LBD || is_locked(cr)){
+            continue;
+        }
+        bool used = c.is_used();
+        c.set_used(false);
+        if(c.get_lbd() <= TIER2_LBD && used){
+            continue;
+        }
+        candidates.push_back(cr);
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [this](Cref a, Cref b) -> bool {
+        Clause ca = arena[a], cb = arena[b];
+        if(ca.get_activity() != cb.get_activity()){
+            return ca.get_activity() < cb.get_activity();
+        }
+        return ca.get_lbd() > cb.get_lbd();
+    });
+    for(size_t i = 0; i != candidates.size() / 2; ++i){
+        remove_clause(candidates[i]);
+    }
+    stats.deleted_clauses += candidates.size() / 2;
+    ++stats.reductions;
+
+    learned_clauses.erase(std::remove_if(learned_clauses.begin(), learned_clauses.end(), [this](Cref cr) -> bool {return arena[cr].is_deleted();}), learned_clauses.end());
+    purge_watches();
+    if(arena.wasted() > arena.size() / 5){
+        collect_garbage();
+    }
+
+    ++reduce_count;
+    next_reduce = stats.conflicts + REDUCE_INTERVAL + REDUCE_INCREMENT * reduce_count;
 }
 
-int Solver::get_backtrack_level(const Disjunction_clause &dc){
+unsigned Solver::compute_lbd(const Disjunction_clause &dc){
     /*
-    Return the second largest decision level among literals in dc.
+    Return the literal block distance of dc: the number of distinct decision levels among its literals.
     */
-    std::vector<int> v;
-    auto literals = dc.get_literals();
-    for(auto lit : literals){
-        int dl = ig.get_decision_level_of_literal(lit);
-        v.push_back(dl);
+    ++lbd_stamp;
+    unsigned lbd = 0;
+    for(auto &lit : dc.get_literals()){
+        int level = levels[lit.get_variable().get_index()];
+        if(level_stamps[level] != lbd_stamp){
+            level_stamps[level] = lbd_stamp;
+            ++lbd;
+        }
     }
+    return lbd;
+}
 
-    std::sort(v.begin(), v.end());
+void Solver::restart(){
+    /*
+    Backtrack to decision level 0. Learned clauses, activities and phases are kept.
+    */
+    backtrack(0);
+    restart_policy->on_restart();
+    ++stats.restarts;
+}
 
-    if(v.size() == 1){
-        return 0;
+void Solver::export_learned_clause(const Disjunction_clause &dc, unsigned lbd){
+    /*
+    Offer a freshly learned clause to the other solvers if it is a unit, a binary, or a short core clause.
+    */
+    if(!exchange || dc.size() > Shared_clause::MAX_SIZE || (dc.size() > 2 && lbd > CORE_LBD)){
+        return;
     }
-    else if(v.size() > 1){
-        return v[v.size()-2];
+    Shared_clause c;
+    c.size = dc.size();
+    c.lbd = lbd;
+    for(size_t k = 0; k != dc.size(); ++k){
+        c.literals[k] = dc[k];
     }
-    else{
-        throw std::runtime_error("Learned nothing.");
+    if(shared_hashes.size() >= MAX_SHARED_HASHES){
+        shared_hashes.clear();
+    }
+    if(shared_hashes.insert(c.hash()).second){
+        exchange->export_clause(exchange_id, c);
+        ++stats.exported_clauses;
     }
 }
 
-int Solver::analyze_conflict(){
+bool Solver::import_shared_clauses(){
     /*
-    Return the decision level that we should backtrack to.
-    Assumption: current assignment leads to a conflict.
+    Add the clauses exported by other solvers since the last call as learned clauses. Literals false at level 0 are
+    dropped and clauses true at level 0 are skipped; imported units are put on the trail for propagation.
+    Return false if an imported clause is falsified at level 0, which means the formula is unsatisfiable.
+    Assumption: decision_level is 0.
     */
+    Shared_clause c;
+    while(exchange->import_clause(exchange_id, c)){
+        if(shared_hashes.size() >= MAX_SHARED_HASHES){
+            shared_hashes.clear();
+        }
+        if(!shared_hashes.insert(c.hash()).second){
+            continue;
+        }
 
-    if(decision_level == 0){
-        return -1;
+        Disjunction_clause dc;
+        bool satisfied = false;
+        for(unsigned k = 0; k != c.size && !satisfied; ++k){
+            Value v = value_of(c.literals[k]);
+            if(v == Value::True){
+                satisfied = true;
+            }
+            else if(v == Value::Unassigned){
+                dc.add_literal(c.literals[k]);
+            }
+        }
+        if(satisfied){
+            continue;
+        }
+        if(dc.size() == 0){
+            return false;
+        }
+
+        ++stats.imported_clauses;
+        if(dc.size() == 2){
+            add_binary_clause(dc[0], dc[1], true);
+            continue;
+        }
+        Cref cr = arena.allocate(dc, true, std::min<unsigned>(c.lbd, dc.size()));
+        learned_clauses.push_back(cr);
+        if(dc.size() == 1){
+            record_a_propagation(dc[0], cr);
+        }
+        else{
+            attach_clause(cr);
+        }
     }
+    return true;
+}
 
-    Node uip = get_first_UIP(decision_level);
+uint32_t Solver::abstract_level(const Variable &v) const{
+    /*
+    Return a one-bit signature of the decision level of v, used to prune the search of minimize_learned_clause.
+    */
+    return uint32_t(1) << (levels[v.get_index()] & 31);
+}
 
-    while(!stop_criterion_met(this->current_conflict_clause, uip)){
-        Literal l = get_last_assigned_literal(this->current_conflict_clause);
-        Variable v = l.get_variable();
-        // since assigning l leads to conflict, not l must has been assigned before.
-        Disjunction_clause antecedent = get_antecedent_clause(!l);
-        this->current_conflict_clause = Disjunction_clause::resolve(this->current_conflict_clause, antecedent, v);
+void Solver::minimize_learned_clause(Disjunction_clause &learned){
+    /*
+    Remove the literals of learned (except the asserting one at position 0) that are implied by the other literals
+    of learned, following reason clauses recursively. Clears seen for every variable it or analysis marked.
+    Assumption: seen is set for the variables of learned[1..].
+    */
+    cleanup_variables.clear();
+    uint32_t levels_in_clause = 0;
+    for(size_t k = 1; k != learned.size(); ++k){
+        cleanup_variables.push_back(learned[k].get_variable());
+        levels_in_clause |= abstract_level(learned[k].get_variable());
     }
 
-    add_learned_clause(this->current_conflict_clause);
-    int dl = get_backtrack_level(this->current_conflict_clause);
-    return dl;
+    size_t j = 1;
+    for(size_t k = 1; k != learned.size(); ++k){
+        Variable v = learned[k].get_variable();
+        if(reasons[v.get_index()] == CREF_UNDEFINED || !literal_is_redundant(learned[k], levels_in_clause)){
+            learned[j++] = learned[k];
+        }
+    }
+    learned.resize(j);
+
+    for(auto &v : cleanup_variables){
+        seen[v.get_index()] = 0;
+    }
+}
+
+bool Solver::literal_is_redundant(const Literal &l, uint32_t levels_in_clause){
+    /*
+    Return true iff l is implied by literals already marked in seen. The reason graph is searched depth-first with
+    an explicit stack; a literal whose decision level does not occur in the clause cannot be implied by it, so the
+    search fails early on it. On failure, marks added by this search are undone.
+    */
+    minimize_stack.clear();
+    minimize_stack.push_back(l);
+    size_t cleanup_top = cleanup_variables.size();
+
+    // Return false if the antecedent q shows that l is not implied.
+    auto visit = [&](const Literal &q) -> bool {
+        Variable v = q.get_variable();
+        if(seen[v.get_index()] || levels[v.get_index()] == 0){
+            return true;
+        }
+        if(reasons[v.get_index()] != CREF_UNDEFINED && (abstract_level(v) & levels_in_clause) != 0){
+            seen[v.get_index()] = 1;
+            minimize_stack.push_back(q);
+            cleanup_variables.push_back(v);
+            return true;
+        }
+        return false;
+    };
+
+    while(!minimize_stack.empty()){
+        Literal p = minimize_stack.back();
+        minimize_stack.pop_back();
+        Cref reason = reasons[p.get_variable().get_index()];
+
+        bool implied = true;
+        if(is_binary_reason(reason)){
+            implied = visit(binary_reason_literal(reason));
+        }
+        else{
+            Clause c = arena[reason];
+            for(size_t k = 1; k != c.size() && implied; ++k){
+                implied = visit(c[k]);
+            }
+        }
+        if(!implied){
+            for(size_t i = cleanup_top; i != cleanup_variables.size(); ++i){
+                seen[cleanup_variables[i].get_index()] = 0;
+            }
+            cleanup_variables.resize(cleanup_top);
+            return false;
+        }
+    }
+    return true;
 }
 
 bool Solver::decide(){
@@ -273,27 +1277,158 @@ bool Solver::decide(){
         Various heuristic may apply when choosing the variable to assign.
     */
 
-    if(unassigned_variables.empty()){
+    Variable variable_chosen_by_heuristic = heuristic->choose_decide_variable(values);
+    if(!variable_chosen_by_heuristic){
         return false;
     }
 
-    Heuristic h;
-    Literal variable_chosen_by_heuristic = h.choose_decide_literal(unassigned_variables);
-
     // record new dicision.
-    trace_new_assignment(variable_chosen_by_heuristic, Disjunction_clause());
-    ig.add_decision_node(variable_chosen_by_heuristic, ++decision_level);
+    ++stats.decisions;
+    trail_limits.push_back(trail.size());
+    ++decision_level;
+    trace_new_assignment(Literal(variable_chosen_by_heuristic, choose_polarity(variable_chosen_by_heuristic)), CREF_UNDEFINED);
 
     return true;
 }
 
+bool Solver::decide_assumption(){
+    /*
+    Open the decision level of the next assumption and assign it. An assumption that already holds gets an empty
+    decision level, so that assumption i always belongs to level i + 1. Return false if the assumption is false.
+    */
+    Literal a = assumptions[decision_level];
+    Value v = value_of(a);
+    if(v == Value::False){
+        return false;
+    }
+    trail_limits.push_back(trail.size());
+    ++decision_level;
+    if(v == Value::Unassigned){
+        ++stats.decisions;
+        trace_new_assignment(a, CREF_UNDEFINED);
+    }
+    return true;
+}
+
+void Solver::analyze_failed_assumption(const Literal &a){
+    /*
+    Collect in failed the assumption a, which is false, and the assumptions that imply !a. The implication graph is
+    walked backwards from !a along the trail; assignments above level 0 without a reason are assumptions.
+    Assumption: every decision level is an assumption level.
+    */
+    failed.clear();
+    failed.push_back(a);
+    size_t var_index = a.get_variable().get_index();
+    if(levels[var_index] == 0){
+        return;
+    }
+
+    seen[var_index] = 1;
+    for(size_t i = trail.size(); i != trail_limits[0]; --i){
+        Variable v = trail[i - 1].get_variable();
+        if(!seen[v.get_index()]){
+            continue;
+        }
+        if(reasons[v.get_index()] == CREF_UNDEFINED){
+            failed.push_back(trail[i - 1]);
+        }
+        else if(is_binary_reason(reasons[v.get_index()])){
+            Variable u = binary_reason_literal(reasons[v.get_index()]).get_variable();
+            if(levels[u.get_index()] > 0){
+                seen[u.get_index()] = 1;
+            }
+        }
+        else{
+            Clause c = arena[reasons[v.get_index()]];
+            for(size_t k = 1; k != c.size(); ++k){
+                if(levels[c[k].get_variable().get_index()] > 0){
+                    seen[c[k].get_variable().get_index()] = 1;
+                }
+            }
+        }
+        seen[v.get_index()] = 0;
+    }
+}
+
+bool Solver::choose_polarity(const Variable &v){
+    /*
+    Return the value to assign to the decision variable v, according to the polarity mode.
+    */
+    switch(options.polarity){
+    case Polarity_mode::Negative:
+        return false;
+    case Polarity_mode::Positive:
+        return true;
+    case Polarity_mode::Random:
+        return random_generator() & 1;
+    case Polarity_mode::Target:
+        if(target_stamps[v.get_index()] == target_stamp){
+            return target_phases[v.get_index()];
+        }
+        return saved_phases[v.get_index()];
+    default:
+        return saved_phases[v.get_index()];
+    }
+}
+
+void Solver::update_target_phases(){
+    /*
+    Called at a conflict, before backtracking. The assignment below the conflicting decision level is conflict-free;
+    remember it as the target (and best) phases when it is the largest one seen. Only the variables it assigns are
+    part of the new target.
+    */
+    size_t consistent_size = trail_limits.back();
+    if(consistent_size > target_size){
+        ++target_stamp;
+        for(size_t i = 0; i != consistent_size; ++i){
+            size_t var_index = trail[i].get_variable().get_index();
+            target_phases[var_index] = trail[i].get_value();
+            target_stamps[var_index] = target_stamp;
+        }
+        target_size = consistent_size;
+    }
+    if(consistent_size > best_size){
+        for(size_t i = 0; i != consistent_size; ++i){
+            best_phases[trail[i].get_variable().get_index()] = trail[i].get_value();
+        }
+        best_size = consistent_size;
+    }
+}
+
+void Solver::rephase(){
+    /*
+    Reset the saved phases, cycling through best, original (positive), best and inverted phases, and forget the
+    target assignment, which is rebuilt from the next conflicts. The best phases are kept across rephases. The
+    interval between rephases grows arithmetically.
+    */
+    switch(rephase_count % 4){
+    case 0:
+    case 2:
+        target_phases = best_phases;
+        break;
+    case 1:
+        std::fill(target_phases.begin(), target_phases.end(), 1);
+        break;
+    default:
+        for(auto &phase : target_phases){
+            phase = !phase;
+        }
+        break;
+    }
+    saved_phases = target_phases;
+    target_size = 0;
+    ++target_stamp;
+    ++rephase_count;
+    next_rephase = stats.conflicts + REPHASE_INTERVAL * (rephase_count + 1);
+}
+
 std::vector<Literal> Solver::get_model(){
     /*
     Return the literals for current assignment.
     */
     std::vector<Literal> v;
-    for(auto p : assignment){
-        v.push_back(p.first);
+    for(auto &l : trail){
+        v.push_back(l);
     }
     return v;
 }
@@ -1,5 +1,6 @@
 /*
-    Solver class. Takes a conjunction_clause object. Call solve() to get result.
+    Solver class. Takes a conjunction_clause object, or clauses one by one through add_clause(). Call solve() to get
+    result; it may be called repeatedly, with assumptions, as clauses are added.
 */
 
 #ifndef SOLVER_H
@@ -7,45 +8,231 @@
 
 #include "conjunction_clause.h"
 #include "implication_graph.h"
+#include "clause_arena.h"
+#include "heuristic.h"
+#include "solver_options.h"
+#include "restart_policy.h"
+#include "statistics.h"
+#include "clause_exchange.h"
+#include "value.h"
 #include <vector>
 #include <set>
+#include <memory>
+#include <random>
+#include <cstdint>
+#include <atomic>
+#include <unordered_set>
+#include <functional>
 
 
 class Implication_graph;
 
+// Outcome of Solver::solve. Unknown means the search was stopped before an answer was found.
+enum class Solve_result { Satisfiable, Unsatisfiable, Unknown };
+
 class Solver{
 friend void dump_debug_info(const Solver &s);
+friend class Lookahead;
 public:
-    Solver(Conjunction_clause c, bool v = false);
-    bool solve();
+    Solver(const Conjunction_clause &c, bool v = false, const Solver_options &o = Solver_options());
+    // Start with an empty formula, to be filled with add_clause().
+    explicit Solver(bool v = false, const Solver_options &o = Solver_options());
+
+    // Incremental interface. Clauses can be added between calls of solve(); learned clauses, activities and phases
+    // are kept from one call to the next.
+    void add_clause(const Disjunction_clause &dc);
+    Solve_result solve(const std::vector<Literal> &assumptions = std::vector<Literal>());
+    // The model of the last solve() that returned Satisfiable, valid until the next add_clause() or solve().
     std::vector<Literal> get_model();
+    Value get_value(const Literal &l) const;
+    // After solve() returned Unsatisfiable: assumptions that together cannot hold. Empty if the formula itself is
+    // unsatisfiable.
+    const std::vector<Literal>& failed_assumptions() const {return failed;}
+    size_t get_num_variables() const {return levels.size();}
+    // solve() gives up with Unknown soon after *flag becomes true. The flag must outlive the search.
+    void set_stop_flag(const std::atomic<bool> *flag) {stop_flag = flag;}
+    // solve() also gives up with Unknown when terminate returns true; it is polled once per decision.
+    void set_terminate_callback(const std::function<bool()> &terminate) {terminate_callback = terminate;}
+    // learn is called with every learned clause, before it is stored.
+    void set_learn_callback(const std::function<void(const Disjunction_clause&)> &learn) {learn_callback = learn;}
+    // Share short learned clauses with the other solvers of exchange, as solver number id. exchange must outlive
+    // the search, and all its solvers must work on the same formula.
+    void set_clause_exchange(Clause_exchange *e, size_t id) {exchange = e; exchange_id = id;}
+    Implication_graph export_implication_graph();
+    const Statistics& get_statistics() const {return stats;}
 private:
-    void trace_new_assignment(const Literal &l, const Disjunction_clause &dc);
-    void update_implication_graph_with_new_propagation(const Literal &l, const Disjunction_clause &dc);
-    void update_implication_graph_if_conflict(const Disjunction_clause &dc);
-    std::vector<Disjunction_clause> get_all_clauses();
-    void record_a_propagation(const Literal &propagated_literal, const Disjunction_clause &by_clause);
+    void trace_new_assignment(const Literal &l, Cref reason);
+    Value value_of(const Literal &l) const;
+    void attach_clause(Cref cr);
+    void add_binary_clause(const Literal &a, const Literal &b, bool learned);
+    void remove_clause(Cref cr);
+    void purge_watches();
+    void collect_garbage();
+    bool enqueue_unit_clauses();
+    void simplify_at_root();
+    void fix_pure_literals();
+    bool inprocess();
+    bool probe(const Literal &l, std::vector<Literal> &implied);
+    bool assign_at_root(const Literal &l);
+    bool probe_variables(uint64_t propagation_limit);
+    bool vivify_clause(Cref cr);
+    bool vivify_clauses(uint64_t propagation_limit);
+    void assert_learned_clause();
+    void record_a_propagation(const Literal &propagated_literal, Cref by_clause);
     bool boolean_constraint_propagation();
-    bool stop_criterion_met(Disjunction_clause &cl, const Node &uip);
-    Literal get_last_assigned_literal(Disjunction_clause dc);
-    Node get_first_UIP(size_t decision_level);
     int analyze_conflict();
-    Disjunction_clause get_antecedent_clause(Literal l);
-    void add_learned_clause(Disjunction_clause dc);
-    int get_backtrack_level(const Disjunction_clause &dc);
+    Cref add_learned_clause(Disjunction_clause dc, unsigned lbd);
+    void bump_clause_activity(Clause c);
+    void update_learned_clause_usage(Clause c);
+    bool is_locked(Cref cr);
+    void reduce_learned_clauses();
     bool decide();
+    bool decide_assumption();
+    void analyze_failed_assumption(const Literal &a);
+    void reserve_variables(size_t n);
+    void add_decision_variable(const Variable &v);
+    bool choose_polarity(const Variable &v);
+    void update_target_phases();
+    void rephase();
+    unsigned compute_lbd(const Disjunction_clause &dc);
+    uint32_t abstract_level(const Variable &v) const;
+    void minimize_learned_clause(Disjunction_clause &learned);
+    bool literal_is_redundant(const Literal &l, uint32_t levels_in_clause);
+    void restart();
     void backtrack(int backtrack_level);
+    void export_learned_clause(const Disjunction_clause &dc, unsigned lbd);
+    bool import_shared_clauses();
 
 
 
-    Conjunction_clause clause;
-    std::vector<Variable> unassigned_variables;
+    Solver_options options;
+    std::unique_ptr<Heuristic> heuristic;
     int decision_level;
     bool verbose;
-    Disjunction_clause current_conflict_clause;
-    std::vector<std::pair<Literal, Disjunction_clause>> assignment;
-    std::vector<Disjunction_clause> learned_clauses;
-    Implication_graph ig;
+    // Set when the formula has an empty clause, or one was derived: the formula is unsatisfiable for good.
+    bool has_empty_clause;
+    // Size of the root assignment at the last simplify_at_root(), to skip it when nothing new is fixed.
+    size_t simplified_trail_size;
+    // Clause falsified by the last propagation, valid when conflict_found is set. A falsified binary clause is
+    // conflict_literal together with the literal of the binary reason conflict_clause.
+    Cref conflict_clause;
+    Literal conflict_literal;
+    bool conflict_found;
+    // First literal of the clause learned by the last conflict analysis, and its reason once it is asserted.
+    Literal asserting_literal;
+    Cref asserting_reason;
+
+    // Assigned literals in assignment order. trail_limits[d] is the trail position of the decision of level d + 1.
+    std::vector<Literal> trail;
+    std::vector<size_t> trail_limits;
+    // Assumptions of the current solve(). Assumption i is decided at level i + 1.
+    std::vector<Literal> assumptions;
+    std::vector<Literal> failed;
+
+    // Clauses of three or more literals, and units, live in the arena. clauses and learned_clauses list the
+    // original and learned ones. Binary clauses only live in binaries.
+    Clause_arena arena;
+    std::vector<Cref> clauses;
+    std::vector<Cref> learned_clauses;
+    // Original clauses with a single literal, assigned at the start of every solve().
+    std::vector<Cref> unit_clauses;
+    // Whether each variable occurs in a clause, and so has been handed to the heuristic.
+    std::vector<char> decision_variables;
+
+    // Two-watched-literal scheme.
+    // watches[l.get_index()] holds the clauses that currently watch l, visited only when l becomes false.
+    std::vector<std::vector<Cref>> watches;
+    // Binary implication lists. binaries[l.get_index()] holds the other literal of every binary clause with l, which
+    // becomes true when l becomes false. Propagation visits them before the watches of longer clauses.
+    struct Binary_watch{
+        Literal other;
+        bool learned;
+    };
+    std::vector<std::vector<Binary_watch>> binaries;
+    // Value of each literal, indexed by literal. A literal and its negation are always updated together.
+    std::vector<Value> values;
+    // Decision level and implying clause of each variable, indexed by variable. Decisions have no reason.
+    // A literal implied by a binary clause has no clause to point to: its reason is the other literal of the
+    // clause, tagged with BINARY_REASON.
+    std::vector<int> levels;
+    std::vector<Cref> reasons;
+    static const Cref BINARY_REASON = CREF_LIMIT;
+    static Cref binary_reason(const Literal &other) {return BINARY_REASON | other.get_index();}
+    static bool is_binary_reason(Cref reason) {return reason != CREF_UNDEFINED && (reason & BINARY_REASON);}
+    static Literal binary_reason_literal(Cref reason) {return Literal::from_index(reason & ~BINARY_REASON);}
+    // Scratch marks used by conflict analysis, indexed by variable. All zero between conflicts.
+    std::vector<char> seen;
+    // Variables marked in seen during the last conflict analysis, reported to the heuristic.
+    std::vector<Variable> analyzed_variables;
+    // Scratch space of learned clause minimization: variables to unmark in seen, and the search stack.
+    std::vector<Variable> cleanup_variables;
+    std::vector<Literal> minimize_stack;
+    // trail[propagation_head..] are the literals whose watches have not been visited yet.
+    size_t propagation_head;
+
+    // Phases, indexed by variable: the last value of each variable, and the values of the largest conflict-free
+    // assignments since the last rephase (target) and overall (best).
+    std::vector<char> saved_phases;
+    std::vector<char> target_phases;
+    std::vector<char> best_phases;
+    size_t target_size;
+    size_t best_size;
+    // A variable is part of the target assignment iff its stamp is target_stamp. The others follow saved_phases.
+    std::vector<uint64_t> target_stamps;
+    uint64_t target_stamp;
+
+    static const uint64_t REPHASE_INTERVAL = 1000;
+    uint64_t next_rephase;
+    uint64_t rephase_count;
+    std::mt19937 random_generator;
+
+    std::unique_ptr<Restart_policy> restart_policy;
+    // Scratch marks for computing LBDs, indexed by decision level.
+    std::vector<uint64_t> level_stamps;
+    uint64_t lbd_stamp;
+
+    // Learned clause database reduction. Learned clauses with LBD up to CORE_LBD are never deleted, those with LBD
+    // up to TIER2_LBD survive while they are used.
+    static const unsigned CORE_LBD = 2;
+    static const unsigned TIER2_LBD = 6;
+    static const uint64_t REDUCE_INTERVAL = 2000;
+    static const uint64_t REDUCE_INCREMENT = 300;
+    static constexpr double CLAUSE_ACTIVITY_DECAY = 0.999;
+    double clause_activity_increment;
+    uint64_t next_reduce;
+    uint64_t reduce_count;
+
+    // Inprocessing rounds run at decision level 0, every INPROCESS_INTERVAL * round conflicts. A round may spend
+    // INPROCESS_EFFORT times the propagations of the search since the previous one, and at least
+    // MIN_INPROCESS_PROPAGATIONS.
+    static const uint64_t INPROCESS_INTERVAL = 2000;
+    static const uint64_t MIN_INPROCESS_PROPAGATIONS = 20000;
+    static constexpr double INPROCESS_EFFORT = 0.1;
+    uint64_t next_inprocess;
+    uint64_t inprocess_count;
+    uint64_t inprocess_propagations;
+    // Where the next round resumes probing variables and vivifying original clauses.
+    size_t probe_position;
+    size_t vivify_position;
+    // Scratch marks of probing, indexed by literal. All zero between probes.
+    std::vector<char> probe_marks;
+    // Pairs of literals found equivalent by probing, whose binary clauses were already added.
+    std::unordered_set<uint64_t> equivalences;
+
+    Statistics stats;
+
+    // Cooperative cancellation, polled once per decision. Null if the search cannot be stopped.
+    const std::atomic<bool> *stop_flag;
+    std::function<bool()> terminate_callback;
+    std::function<void(const Disjunction_clause&)> learn_callback;
+
+    // Clause sharing. Units, binaries and core clauses of at most Shared_clause::MAX_SIZE literals are exported,
+    // and clauses from other solvers are imported at decision level 0. shared_hashes holds the hashes of clauses
+    // exported or imported so far, to avoid sharing the same clause twice.
+    Clause_exchange *exchange;
+    size_t exchange_id;
+    std::unordered_set<uint64_t> shared_hashes;
+    static const size_t MAX_SHARED_HASHES = 1 << 20;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,57 @@
+/*
+    Tunable settings of a Solver. Defaults are used for anything not set on the command line.
+*/
+
+#ifndef SOLVER_OPTIONS_H
+#define SOLVER_OPTIONS_H
+
+#include <string>
+#include <stdexcept>
+
+// How the value of a decision variable is chosen.
+//  - Saved: reuse the value the variable had before it was last unassigned (phase saving).
+//  - Negative / Positive: always assign false / true.
+//  - Random: pick a value at random.
+//  - Target: follow the largest conflict-free assignment seen since the last rephase, and periodically reset the
+//    saved phases to the best assignment seen so far, the original phases or their inversion.
+enum class Polarity_mode { Saved, Negative, Positive, Random, Target };
+
+class Solver_options{
+public:
+    Solver_options() : heuristic("evsids"), polarity(Polarity_mode::Saved), seed(0), restart("ema"), inprocess(true), one_shot(false) {}
+
+    static Polarity_mode parse_polarity(const std::string &name){
+        if(name == "saved") return Polarity_mode::Saved;
+        if(name == "negative") return Polarity_mode::Negative;
+        if(name == "positive") return Polarity_mode::Positive;
+        if(name == "random") return Polarity_mode::Random;
+        if(name == "target") return Polarity_mode::Target;
+        throw std::invalid_argument("Unknown polarity mode " + name);
+    }
+
+    static std::string polarity_name(Polarity_mode mode){
+        switch(mode){
+            case Polarity_mode::Saved: return "saved";
+            case Polarity_mode::Negative: return "negative";
+            case Polarity_mode::Positive: return "positive";
+            case Polarity_mode::Random: return "random";
+            case Polarity_mode::Target: return "target";
+        }
+        return "unknown";
+    }
+
+    // Decision heuristic: "evsids" or "vmtf".
+    std::string heuristic;
+    Polarity_mode polarity;
+    // Seed of the random number generator used for random polarities.
+    unsigned seed;
+    // Restart policy: "luby", "geometric", "ema" or "none".
+    std::string restart;
+    // Whether to run rounds of failed literal probing and clause vivification between restarts.
+    bool inprocess;
+    // Set when solve() is called once, without assumptions, and no clause is added after it. The solver may then
+    // fix pure literals, which keeps the formula satisfiable but not equivalent.
+    bool one_shot;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#include "solver.h"
+#include <iostream>
+
+static int failures = 0;
+
+static void check(bool condition, const char *message){
+    if(!condition){
+        std::cout << "FAILED: " << message << "\n";
+        ++failures;
+    }
+}
+
+static Disjunction_clause clause(std::vector<Literal> literals){
+    return Disjunction_clause(std::move(literals));
+}
+
+int main(){
+    // (x0 v x1) & (x0 v x2) & (-x1 v x2): x0 is pure.
+    Literal x0(Variable(0)), x1(Variable(1)), x2(Variable(2));
+    Conjunction_clause cnf;
+    cnf.reserve_variables(3);
+    cnf.add_clause(clause({x0, x1}));
+    cnf.add_clause(clause({x0, x2}));
+    cnf.add_clause(clause({!x1, x2}));
+
+    // Pure literals must not be fixed for good unless the solver is told it is solved only once.
+    Solver s(cnf);
+    check(s.solve() == Solve_result::Satisfiable, "formula is satisfiable");
+    check(s.solve({!x0}) == Solve_result::Satisfiable, "assuming the negation of a pure literal is satisfiable");
+    check(s.get_value(x1) == Value::True && s.get_value(x2) == Value::True, "model under the assumption");
+    s.add_clause(clause({!x0}));
+    check(s.solve() == Solve_result::Satisfiable, "adding the negation of a pure literal keeps it satisfiable");
+    check(s.get_value(x0) == Value::False, "model satisfies the added clause");
+    s.add_clause(clause({!x2}));
+    check(s.solve() == Solve_result::Unsatisfiable, "formula becomes unsatisfiable");
+
+    Solver_options one_shot;
+    one_shot.one_shot = true;
+    Solver t(cnf, false, one_shot);
+    check(t.solve() == Solve_result::Satisfiable, "one-shot solver finds a model");
+
+    if(failures == 0){
+        std::cout << "ok\n";
+    }
+    return failures == 0 ? 0 : 1;
+}
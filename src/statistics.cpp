@@ -0,0 +1,35 @@
+#include "statistics.h"
+#include <ctime>
+
+double thread_cpu_seconds(){
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+std::ostream& operator<<(std::ostream &os, const Statistics &s){
+    os << "c decisions: " << s.decisions << "\n";
+    os << "c propagations: " << s.propagations << "\n";
+    os << "c conflicts: " << s.conflicts << "\n";
+    os << "c restarts: " << s.restarts << "\n";
+    os << "c reductions: " << s.reductions << "\n";
+    os << "c deleted clauses: " << s.deleted_clauses << "\n";
+    os << "c learned literals: " << s.learned_literals << "\n";
+    uint64_t before_minimization = s.learned_literals + s.minimized_literals;
+    os << "c minimized literals: " << s.minimized_literals;
+    if(before_minimization){
+        os << " (" << 100.0 * s.minimized_literals / before_minimization << "%)";
+    }
+    os << "\n";
+    os << "c exported clauses: " << s.exported_clauses << "\n";
+    os << "c imported clauses: " << s.imported_clauses << "\n";
+    os << "c root satisfied clauses: " << s.root_satisfied_clauses << "\n";
+    os << "c root false literals: " << s.root_false_literals << "\n";
+    os << "c pure literals: " << s.pure_literals << "\n";
+    os << "c inprocessing rounds: " << s.inprocessing_rounds << "\n";
+    os << "c failed literals: " << s.failed_literals << "\n";
+    os << "c equivalent literals: " << s.equivalent_literals << "\n";
+    os << "c vivified clauses: " << s.vivified_clauses << "\n";
+    os << "c vivified literals: " << s.vivified_literals << "\n";
+    return os;
+}
@@ -0,0 +1,49 @@
+/*
+    Counters collected by a Solver during search.
+*/
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <cstdint>
+#include <iostream>
+
+class Statistics{
+friend std::ostream& operator<<(std::ostream &os, const Statistics &s);
+public:
+    Statistics() : decisions(0), propagations(0), conflicts(0), restarts(0), reductions(0), deleted_clauses(0), learned_literals(0), minimized_literals(0), exported_clauses(0), imported_clauses(0), root_satisfied_clauses(0), root_false_literals(0), pure_literals(0), inprocessing_rounds(0), failed_literals(0), equivalent_literals(0), vivified_clauses(0), vivified_literals(0) {}
+
+    uint64_t decisions;
+    uint64_t propagations;
+    uint64_t conflicts;
+    uint64_t restarts;
+    // Learned clause database reductions, and learned clauses deleted by them.
+    uint64_t reductions;
+    uint64_t deleted_clauses;
+    // Literals in learned clauses after minimization, and literals removed by minimization.
+    uint64_t learned_literals;
+    uint64_t minimized_literals;
+    // Clauses sent to and received from other solvers.
+    uint64_t exported_clauses;
+    uint64_t imported_clauses;
+    // Clauses deleted because the root assignment satisfies them, false literals removed from the others, and
+    // pure literals fixed at the root.
+    uint64_t root_satisfied_clauses;
+    uint64_t root_false_literals;
+    uint64_t pure_literals;
+    // Inprocessing: rounds run, probes that failed, equivalences found by probing, and clauses shortened by
+    // vivification with the literals removed from them.
+    uint64_t inprocessing_rounds;
+    uint64_t failed_literals;
+    uint64_t equivalent_literals;
+    uint64_t vivified_clauses;
+    uint64_t vivified_literals;
+};
+
+// CPU time consumed so far by the calling thread, in seconds.
+double thread_cpu_seconds();
+
+// Print one "c name: value" line per counter, as DIMACS comments.
+std::ostream& operator<<(std::ostream &os, const Statistics &s);
+
+#endif
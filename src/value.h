@@ -0,0 +1,7 @@
+#ifndef VALUE_H
+#define VALUE_H
+
+// Value of a literal under the current assignment.
+enum class Value { False, True, Unassigned };
+
+#endif
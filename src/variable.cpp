@@ -1,10 +1,12 @@
 #include "variable.h"
-#include <algorithm>
-#include <vector>
 
-size_t Variable::index = 0;
+const uint32_t Variable::UNDEFINED;
 
 std::ostream& operator<<(std::ostream &os, const Variable &v){
-    os << v.name;
+    if(!v){
+        os << "?";
+        return os;
+    }
+    os << "x" << v.get_index() + 1;
     return os;
 }
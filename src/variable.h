@@ -5,42 +5,43 @@
 #ifndef VARIABLE_H
 #define VARIABLE_H
 
-#include <string>
+#include <cstdint>
 #include <iostream>
 
 class Variable{
-friend std::ostream& operator<<(std::ostream &os, const Variable &v);
-friend bool conflict(std::vector<std::pair<Variable, size_t>> &v);
 friend class VariableHash;
 public:
-    Variable(std::string n="v"+std::to_string(index)) : name(n){}
+    // Index of the invalid variable. Chosen so that both of its literals still fit in 32 bits.
+    static const uint32_t UNDEFINED = 0x7FFFFFFF;
 
-    std::string get_name() const{
-        return this->name;
+    // Variables are dense indices starting from 0. Their names live in a side table of the formula.
+    explicit Variable(uint32_t i = UNDEFINED) : index(i){}
+
+    uint32_t get_index() const{
+        return this->index;
     }
 
     explicit operator bool() const{
-        return name.empty() ? false : true;
+        return index != UNDEFINED;
     }
 
-    bool operator==(const Variable &v) const {return this->name == v.name;}
+    bool operator==(const Variable &v) const {return this->index == v.index;}
     bool operator!=(const Variable &v) const {return !(*this == v);}
 
 private:
-    // if name is "", then it's an invalid variable.
-    std::string name;
-    static size_t index;
+    // if index is UNDEFINED, then it's an invalid variable.
+    uint32_t index;
 };
 
+// Print the default name of v, which is the DIMACS name prefixed by 'x'.
 std::ostream& operator<<(std::ostream &os, const Variable &v);
-bool conflict(std::vector<std::pair<Variable, size_t>> &v);
 
 class VariableHash{
-    // Compute hash based on underlying name and value.
+    // Variables are dense, so the index itself is a perfect hash.
 public:
     size_t operator()(const Variable &v) const{
-        return std::hash<std::string>()(v.name);
+        return v.index;
     }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,85 @@
+#include "vmtf_heuristic.h"
+#include <algorithm>
+
+VMTF_heuristic::VMTF_heuristic(const std::vector<Variable> &vars, size_t num_variables) : prev(num_variables, Variable::UNDEFINED), next(num_variables, Variable::UNDEFINED), stamps(num_variables, 0), first(Variable::UNDEFINED), last(Variable::UNDEFINED), search(Variable::UNDEFINED), stamp_counter(0) {
+    // Enqueue in reverse, so that the first variable is the first decision.
+    for(auto iter = vars.rbegin(); iter != vars.rend(); ++iter){
+        move_to_front(iter->get_index());
+    }
+    search = last;
+}
+
+void VMTF_heuristic::move_to_front(uint32_t index){
+    /*
+    Unlink index from the queue (if linked) and append it as the most recent variable.
+    */
+    if(prev[index] != Variable::UNDEFINED){
+        next[prev[index]] = next[index];
+    }
+    else if(first == index){
+        first = next[index];
+    }
+    if(next[index] != Variable::UNDEFINED){
+        prev[next[index]] = prev[index];
+    }
+    else if(last == index){
+        last = prev[index];
+    }
+
+    prev[index] = last;
+    next[index] = Variable::UNDEFINED;
+    if(last != Variable::UNDEFINED){
+        next[last] = index;
+    }
+    else{
+        first = index;
+    }
+    last = index;
+    stamps[index] = ++stamp_counter;
+}
+
+Variable VMTF_heuristic::choose_decide_variable(const std::vector<Value> &values){
+    while(search != Variable::UNDEFINED && values[Literal(Variable(search)).get_index()] != Value::Unassigned){
+        search = prev[search];
+    }
+    return Variable(search);
+}
+
+void VMTF_heuristic::bump_variables(const std::vector<Variable> &vars){
+    /*
+    Move the variables to the front, keeping their relative order, so the queue order stays stable.
+    */
+    sorted = vars;
+    std::sort(sorted.begin(), sorted.end(), [this](const Variable &a, const Variable &b) -> bool {return stamps[a.get_index()] < stamps[b.get_index()];});
+    bool search_moved = false;
+    for(auto &v : sorted){
+        search_moved = search_moved || v.get_index() == search;
+        move_to_front(v.get_index());
+    }
+    // Bumped variables are assigned during analysis. They move search once they get unassigned on backtracking.
+    if(search_moved){
+        search = last;
+    }
+}
+
+void VMTF_heuristic::unassign(const Variable &v){
+    if(search == Variable::UNDEFINED || stamps[v.get_index()] > stamps[search]){
+        search = v.get_index();
+    }
+}
+
+void VMTF_heuristic::add_variable(const Variable &v){
+    /*
+    Enqueue v as the most recent variable. It is unassigned, so it is where the next search starts.
+    */
+    uint32_t index = v.get_index();
+    if(index >= stamps.size()){
+        prev.resize(index + 1, Variable::UNDEFINED);
+        next.resize(index + 1, Variable::UNDEFINED);
+        stamps.resize(index + 1, 0);
+    }
+    if(stamps[index] == 0){
+        move_to_front(index);
+        search = index;
+    }
+}
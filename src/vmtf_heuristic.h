@@ -0,0 +1,34 @@
+/*
+    Variable move-to-front. Variables are kept in a queue ordered by the time they were last bumped. Bumped variables
+    move to the front, and decisions take the most recently bumped unassigned variable.
+*/
+
+#ifndef VMTF_HEURISTIC_H
+#define VMTF_HEURISTIC_H
+
+#include "heuristic.h"
+#include <cstdint>
+
+class VMTF_heuristic : public Heuristic{
+public:
+    VMTF_heuristic(const std::vector<Variable> &vars, size_t num_variables);
+
+    Variable choose_decide_variable(const std::vector<Value> &values) override;
+    void bump_variables(const std::vector<Variable> &vars) override;
+    void unassign(const Variable &v) override;
+    void add_variable(const Variable &v) override;
+
+private:
+    void move_to_front(uint32_t index);
+
+    // Doubly linked queue. last is the most recently bumped variable; prev points towards older ones.
+    std::vector<uint32_t> prev, next;
+    std::vector<uint64_t> stamps;
+    uint32_t first, last;
+    // Every variable more recent than search is assigned.
+    uint32_t search;
+    uint64_t stamp_counter;
+    std::vector<Variable> sorted;
+};
+
+#endif